@@ -21,6 +21,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -42,7 +43,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterType converterType);
 	~Channel();
 
 	/**
@@ -197,15 +198,22 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _converterType(kRateConverterLinear), _commandHead(0), _commandTail(0) {
 
 	assert(sampleRate > 0);
 
+	_converterType = parseRateConverterType(ConfMan.get("audio_resampler"));
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = nullptr;
+	memset(_slots, 0, sizeof(_slots));
 }
 
 MixerImpl::~MixerImpl() {
+	// Insert the channels of sounds which never got mixed, so they are freed too
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
 }
@@ -228,14 +236,85 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
-	int index = -1;
+int MixerImpl::reserveSlot(SoundHandle &handle, Channel *chan) {
+	// _commandMutex must be held
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == nullptr) {
-			index = i;
-			break;
+		SlotState &slot = _slots[i];
+		if (!Common::atomicLoadAcquire(&slot.used)) {
+			handle._val = i + (_handleSeed * NUM_CHANNELS);
+			_handleSeed++;
+
+			Common::atomicStoreRelease(&slot.handle, handle._val);
+			Common::atomicStoreRelease(&slot.id, (int32)chan->getId());
+			Common::atomicStoreRelease(&slot.type, (int32)chan->getType());
+			Common::atomicStoreRelease(&slot.volume, (uint32)chan->getVolume());
+			Common::atomicStoreRelease(&slot.balance, (int32)chan->getBalance());
+			Common::atomicStoreRelease(&slot.rate, chan->getRate());
+			Common::atomicStoreRelease(&slot.streamRate, chan->getRate());
+			Common::atomicStoreRelease(&slot.used, (uint32)1);
+			return i;
 		}
 	}
+
+	return -1;
+}
+
+const MixerImpl::SlotState *MixerImpl::findSlot(SoundHandle handle) const {
+	const SlotState &slot = _slots[handle._val % NUM_CHANNELS];
+	if (!Common::atomicLoadAcquire(&slot.used) || Common::atomicLoadAcquire(&slot.handle) != handle._val)
+		return nullptr;
+
+	return &slot;
+}
+
+void MixerImpl::updateSlot(const Command &command) {
+	// _commandMutex must be held. Commands for sounds which already
+	// terminated are ignored, as applyCommand() does
+	SlotState *slot = const_cast<SlotState *>(findSlot(command.handle));
+	if (!slot)
+		return;
+
+	switch (command.type) {
+	case kCommandSetVolume:
+		Common::atomicStoreRelease(&slot->volume, (uint32)command.volume);
+		break;
+	case kCommandSetBalance:
+		Common::atomicStoreRelease(&slot->balance, (int32)command.balance);
+		break;
+	case kCommandSetRate:
+		Common::atomicStoreRelease(&slot->rate, command.rate);
+		break;
+	case kCommandResetRate:
+		Common::atomicStoreRelease(&slot->rate, Common::atomicLoadAcquire(&slot->streamRate));
+		break;
+	default:
+		break;
+	}
+}
+
+Channel *MixerImpl::findChannel(SoundHandle handle) {
+	const int index = handle._val % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+		return nullptr;
+
+	return _channels[index];
+}
+
+void MixerImpl::deleteChannel(int index) {
+	delete _channels[index];
+	_channels[index] = nullptr;
+	Common::atomicStoreRelease(&_slots[index].used, (uint32)0);
+}
+
+void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+	// _mutex must be held
+	SoundHandle chanHandle;
+	int index;
+	{
+		Common::StackLock lock(_commandMutex);
+		index = reserveSlot(chanHandle, chan);
+	}
+
 	if (index == -1) {
 		warning("MixerImpl::out of mixer slots");
 		delete chan;
@@ -244,15 +323,109 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 
 	_channels[index] = chan;
 
-	SoundHandle chanHandle;
-	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
-
 	chan->setHandle(chanHandle);
-	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
 }
 
+bool MixerImpl::queueCommand(const Command &command) {
+	// _commandMutex must be held
+#ifdef SCUMMVM_ATOMICS
+	const uint32 head = _commandHead;
+	if (head - Common::atomicLoadAcquire(&_commandTail) >= COMMAND_QUEUE_SIZE)
+		return false;
+
+	_commands[head % COMMAND_QUEUE_SIZE] = command;
+	Common::atomicStoreRelease(&_commandHead, head + 1);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void MixerImpl::sendCommand(const Command &command) {
+	{
+		Common::StackLock lock(_commandMutex);
+		updateSlot(command);
+		if (queueCommand(command))
+			return;
+	}
+
+	// The queue is full, apply the command directly
+	Common::StackLock lock(_mutex);
+	processCommands();
+	applyCommand(command);
+}
+
+void MixerImpl::processCommands() {
+	// _mutex must be held, which makes the caller the only consumer
+#ifdef SCUMMVM_ATOMICS
+	uint32 tail = _commandTail;
+	const uint32 head = Common::atomicLoadAcquire(&_commandHead);
+
+	for (; tail != head; tail++)
+		applyCommand(_commands[tail % COMMAND_QUEUE_SIZE]);
+
+	Common::atomicStoreRelease(&_commandTail, tail);
+#endif
+}
+
+void MixerImpl::applyCommand(const Command &command) {
+	if (command.type == kCommandPlay) {
+		const int index = command.handle._val % NUM_CHANNELS;
+		assert(!_channels[index]);
+		_channels[index] = command.channel;
+		return;
+	}
+
+	if (command.type == kCommandPauseAll) {
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr) {
+				_channels[i]->pause(command.paused);
+			}
+		}
+		return;
+	}
+
+	if (command.type == kCommandPauseID) {
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr && _channels[i]->getId() == command.id) {
+				_channels[i]->pause(command.paused);
+				return;
+			}
+		}
+		return;
+	}
+
+	// Simply ignore requests for handles of sounds that already terminated
+	Channel *chan = findChannel(command.handle);
+	if (!chan)
+		return;
+
+	switch (command.type) {
+	case kCommandSetVolume:
+		chan->setVolume(command.volume);
+		break;
+	case kCommandSetBalance:
+		chan->setBalance(command.balance);
+		break;
+	case kCommandSetRate:
+		chan->setRate(command.rate);
+		break;
+	case kCommandResetRate:
+		chan->resetRate();
+		break;
+	case kCommandLoop:
+		chan->loop();
+		break;
+	case kCommandPauseHandle:
+		chan->pause(command.paused);
+		break;
+	default:
+		break;
+	}
+}
+
 void MixerImpl::playStream(
 			SoundType type,
 			SoundHandle *handle,
@@ -261,8 +434,6 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
-
 	if (stream == nullptr) {
 		warning("stream is 0");
 		return;
@@ -271,6 +442,47 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
+#ifdef AUDIO_REVERSE_STEREO
+	reverseStereo = !reverseStereo;
+#endif
+
+	// Create the channel
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _converterType);
+	chan->setVolume(volume);
+	chan->setBalance(balance);
+
+#ifdef SCUMMVM_ATOMICS
+	// Sounds without an id can't be duplicates, so they can be started
+	// without waiting for the mixer
+	if (id == -1) {
+		Common::StackLock lock(_commandMutex);
+
+		Command command;
+		command.type = kCommandPlay;
+		command.channel = chan;
+
+		const int index = reserveSlot(command.handle, chan);
+		if (index == -1) {
+			warning("MixerImpl::out of mixer slots");
+			delete chan;
+			return;
+		}
+
+		chan->setHandle(command.handle);
+		if (queueCommand(command)) {
+			if (handle)
+				*handle = command.handle;
+			return;
+		}
+
+		// The queue is full, insert the channel directly
+		Common::atomicStoreRelease(&_slots[index].used, (uint32)0);
+	}
+#endif
+
+	Common::StackLock lock(_mutex);
+	processCommands();
+
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
@@ -281,20 +493,11 @@ void MixerImpl::playStream(
 				// keep in mind here is QueuingAudioStream.
 				// Thus, as a quick rule of thumb, you should never, ever,
 				// try to play QueuingAudioStreams with a sound id.
-				if (autofreeStream == DisposeAfterUse::YES)
-					delete stream;
+				delete chan;
 				return;
 			}
 	}
 
-#ifdef AUDIO_REVERSE_STEREO
-	reverseStereo = !reverseStereo;
-#endif
-
-	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
-	chan->setVolume(volume);
-	chan->setBalance(balance);
 	insertChannel(handle, chan);
 }
 
@@ -303,6 +506,9 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 	Common::StackLock lock(_mutex);
 
+	// Apply everything the engine requested since the last callback
+	processCommands();
+
 	int16 *buf = (int16 *)samples;
 
 	// Since the mixer callback has been called, the mixer must be ready...
@@ -325,8 +531,7 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
+				deleteChannel(i);
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
 
@@ -340,34 +545,35 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+			deleteChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+			deleteChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!findChannel(handle))
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	deleteChannel(handle._val % NUM_CHANNELS);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
@@ -386,67 +592,58 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	Command command;
+	command.type = kCommandSetVolume;
+	command.handle = handle;
+	command.volume = volume;
+	sendCommand(command);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const SlotState *slot = findSlot(handle);
+	if (!slot)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return (byte)Common::atomicLoadAcquire(&slot->volume);
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	Command command;
+	command.type = kCommandSetBalance;
+	command.handle = handle;
+	command.balance = balance;
+	sendCommand(command);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const SlotState *slot = findSlot(handle);
+	if (!slot)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return (int8)Common::atomicLoadAcquire(&slot->balance);
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setRate(rate);
+	Command command;
+	command.type = kCommandSetRate;
+	command.handle = handle;
+	command.rate = rate;
+	sendCommand(command);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const SlotState *slot = findSlot(handle);
+	if (!slot)
 		return 0;
-	
-	return _channels[index]->getRate();
+
+	return (uint32)Common::atomicLoadAcquire(&slot->rate);
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-	
-	_channels[index]->resetRate();
+	Command command;
+	command.type = kCommandResetRate;
+	command.handle = handle;
+	sendCommand(command);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -455,90 +652,74 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return chan->getElapsedTime();
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->loop();
+	Command command;
+	command.type = kCommandLoop;
+	command.handle = handle;
+	sendCommand(command);
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
-		}
-	}
+	Command command;
+	command.type = kCommandPauseAll;
+	command.paused = paused;
+	sendCommand(command);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
-			return;
-		}
-	}
+	Command command;
+	command.type = kCommandPauseID;
+	command.id = id;
+	command.paused = paused;
+	sendCommand(command);
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
-
-	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->pause(paused);
+	Command command;
+	command.type = kCommandPauseHandle;
+	command.handle = handle;
+	command.paused = paused;
+	sendCommand(command);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (Common::atomicLoadAcquire(&_slots[i].used) && Common::atomicLoadAcquire(&_slots[i].id) == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	const SlotState *slot = findSlot(handle);
+	if (slot)
+		return Common::atomicLoadAcquire(&slot->id);
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findSlot(handle) != nullptr;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (Common::atomicLoadAcquire(&_slots[i].used) && Common::atomicLoadAcquire(&_slots[i].type) == (int32)type)
 			return true;
 	return false;
 }
@@ -553,6 +734,8 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// scaling? See also Player_V2::setMasterVolume
 
 	Common::StackLock lock(_mutex);
+	processCommands();
+
 	_soundTypeSettings[type].volume = volume;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
@@ -573,7 +756,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterType converterType)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
@@ -582,7 +765,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo, converterType);
 }
 
 Channel::~Channel() {
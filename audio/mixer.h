@@ -94,6 +94,10 @@ public:
 
 	/**
 	 * Return the mixer's internal mutex so that audio players can use it.
+	 *
+	 * Holding it keeps the mixer from mixing, but channel changes requested
+	 * before may not have been applied yet. The other methods of the mixer
+	 * apply them before they return any state.
 	 */
 	virtual Common::Mutex &mutex() = 0;
 
@@ -23,8 +23,10 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/atomic.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -49,6 +51,25 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * Calls which only change the state of a channel (starting a sound without
+ * an id, volume, balance, rate and pause changes) don't take the mixer mutex,
+ * which mixCallback() holds while mixing. Instead, they are posted to a
+ * command queue which mixCallback() drains before mixing, so they never wait
+ * for a mix pass to finish. The queue is not lock-free: the callers are
+ * serialized by a separate mutex, which is only held while a command is
+ * added and which the audio callback never takes.
+ *
+ * The getters for the volume, balance, rate and id of a sound, and whether
+ * a sound is active, don't take the mixer mutex either. They answer from a
+ * copy of the state of each slot, which the callers update when they post a
+ * command, so it already holds the values of the pending commands.
+ *
+ * Calls which stop sounds, and getElapsedTime(), still lock the mixer mutex,
+ * and apply the pending commands first: once stopHandle() and friends
+ * return, the stream of the sound is no longer used by the mixer. Locking
+ * mutex() directly doesn't apply them, so commands may still be pending while
+ * it is held.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -58,7 +79,8 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256
 	};
 
 	Common::Mutex _mutex;
@@ -79,6 +101,75 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	/** Sample rate conversion used for new channels, from the "audio_resampler" setting */
+	RateConverterType _converterType;
+
+	enum CommandType {
+		kCommandPlay,
+		kCommandSetVolume,
+		kCommandSetBalance,
+		kCommandSetRate,
+		kCommandResetRate,
+		kCommandLoop,
+		kCommandPauseHandle,
+		kCommandPauseID,
+		kCommandPauseAll
+	};
+
+	struct Command {
+		Command() : type(kCommandPlay), channel(nullptr), paused(false) {}
+
+		CommandType type;
+		SoundHandle handle;
+		union {
+			Channel *channel;
+			int id;
+			byte volume;
+			int8 balance;
+			uint32 rate;
+		};
+		bool paused;
+	};
+
+	/**
+	 * The command queue. Producers are serialized by _commandMutex, which
+	 * the audio thread never takes. Commands are consumed with _mutex held.
+	 */
+	Command _commands[COMMAND_QUEUE_SIZE];
+	uint32 _commandHead;
+	uint32 _commandTail;
+	Common::Mutex _commandMutex;
+
+	/**
+	 * The requested state of the sound in a slot, for the getters. Written
+	 * by the producers with _commandMutex held and read without any lock.
+	 * @c used is set when the slot is reserved, after the other fields, and
+	 * cleared when its channel is deleted.
+	 */
+	struct SlotState {
+		uint32 used;
+		uint32 handle;
+		int32 id;
+		int32 type;
+		uint32 volume;
+		int32 balance;
+		uint32 rate;
+		uint32 streamRate;
+	};
+
+	SlotState _slots[NUM_CHANNELS];
+
+	bool queueCommand(const Command &command);
+	void sendCommand(const Command &command);
+	void processCommands();
+	void applyCommand(const Command &command);
+	void updateSlot(const Command &command);
+	const SlotState *findSlot(SoundHandle handle) const;
+
+	int reserveSlot(SoundHandle &handle, Channel *chan);
+	Channel *findChannel(SoundHandle handle);
+	void deleteChannel(int index);
+
 
 public:
 
@@ -22,6 +22,7 @@ MODULE_OBJS := \
 	musicplugin.o \
 	null.o \
 	rate.o \
+	rate_sinc.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
@@ -109,5 +110,18 @@ MODULE_OBJS += \
 	rwopl3.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate_neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate_sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	rate_avx2.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
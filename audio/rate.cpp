@@ -29,7 +29,9 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Audio {
@@ -76,6 +78,22 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
+	/** Function used to scale and mix the converted samples into the output */
+	RateMix::MixFunc _mixFunc;
+
+	/**
+	 * Mix numFrames frames in the input format from in into out, and return
+	 * the number of samples written.
+	 */
+	int mix(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+		// The SIMD mixers only handle volumes up to kMaxMixerVolume
+		if (volL > Audio::Mixer::kMaxMixerVolume || volR > Audio::Mixer::kMaxMixerVolume)
+			RateMix::mixGeneric<inStereo, outStereo, reverseStereo>(out, in, numFrames, volL, volR);
+		else
+			_mixFunc(out, in, numFrames, volL, volR);
+		return numFrames * (outStereo ? 2 : 1);
+	}
+
 	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
@@ -112,30 +130,11 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStr
 				return (outBuffer - outStart) / (outStereo ? 2 : 1);
 		}
 
-		// Mix the data into the output buffer
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
-		_bufferSize -= (inStereo ? 2 : 1);
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		// Mix as much of the buffered data as fits into the output buffer
+		st_size_t numFrames = MIN<st_size_t>(_bufferSize / (inStereo ? 2 : 1), (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		outBuffer += mix(outBuffer, _bufferPos, numFrames, volL, volR);
+		_bufferPos += numFrames * (inStereo ? 2 : 1);
+		_bufferSize -= numFrames * (inStereo ? 2 : 1);
 	}
 
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
@@ -151,51 +150,48 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
 
-	while (outBuffer < outEnd) {
-		// Read enough input samples so that _outPos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
-
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
-			}
-
-			_bufferSize -= (inStereo ? 2 : 1);
-			_outPos--;
+	// The picked input samples are collected here, then mixed in one go
+	st_sample_t mixBuffer[ARRAYSIZE(_buffer)];
+	bool endOfInput = false;
 
-			if (_outPos >= 0) {
-				_bufferPos += (inStereo ? 2 : 1);
-			}
-		} while (_outPos >= 0);
+	while (outBuffer < outEnd && !endOfInput) {
+		st_sample_t *mixPos = mixBuffer;
+		st_sample_t *mixEnd = mixBuffer + MIN<st_size_t>(ARRAYSIZE(mixBuffer) / 2, (outEnd - outBuffer) / (outStereo ? 2 : 1)) * (inStereo ? 2 : 1);
 
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
+		while (mixPos < mixEnd) {
+			// Read enough input samples so that _outPos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
-		// Increment output position
-		_outPos += outPos_inc;
+					if (_bufferSize <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+				_bufferSize -= (inStereo ? 2 : 1);
+				_outPos--;
 
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
+				if (_outPos >= 0) {
+					_bufferPos += (inStereo ? 2 : 1);
+				}
+			} while (_outPos >= 0);
 
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+			if (endOfInput)
+				break;
 
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
+			*mixPos++ = *_bufferPos++;
+			if (inStereo)
+				*mixPos++ = *_bufferPos++;
 
-			outBuffer += 1;
+			// Increment output position
+			_outPos += outPos_inc;
 		}
+
+		outBuffer += mix(outBuffer, mixBuffer, (mixPos - mixBuffer) / (inStereo ? 2 : 1), volL, volR);
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
@@ -209,62 +205,57 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
 
-	while (outBuffer < outEnd) {
-		// Read enough input samples so that _outPosFrac < 0
-		while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
-			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
-
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	// The interpolated samples are collected here, then mixed in one go
+	st_sample_t mixBuffer[ARRAYSIZE(_buffer)];
+	bool endOfInput = false;
+
+	while (outBuffer < outEnd && !endOfInput) {
+		st_sample_t *mixPos = mixBuffer;
+		st_sample_t *mixEnd = mixBuffer + MIN<st_size_t>(ARRAYSIZE(mixBuffer) / 2, (outEnd - outBuffer) / (outStereo ? 2 : 1)) * (inStereo ? 2 : 1);
+
+		while (mixPos < mixEnd) {
+			// Read enough input samples so that _outPosFrac < 0
+			while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+					if (_bufferSize <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+
+				_bufferSize -= (inStereo ? 2 : 1);
+				_inLastL = _inCurL;
+				_inCurL = *_bufferPos++;
+
+				if (inStereo) {
+					_inLastR = _inCurR;
+					_inCurR = *_bufferPos++;
+				}
+
+				_outPosFrac -= FRAC_ONE_LOW;
 			}
 
-			_bufferSize -= (inStereo ? 2 : 1);
-			_inLastL = _inCurL;
-			_inCurL = *_bufferPos++;
+			if (endOfInput)
+				break;
 
-			if (inStereo) {
-				_inLastR = _inCurR;
-				_inCurR = *_bufferPos++;
-			}
-
-			_outPosFrac -= FRAC_ONE_LOW;
-		}
+			// Loop as long as the _outPos trails behind, and as long as there is
+			// still space in the output buffer.
+			while (_outPosFrac < (frac_t)FRAC_ONE_LOW && mixPos < mixEnd) {
+				// Interpolate
+				*mixPos++ = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				if (inStereo)
+					*mixPos++ = (st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
-		// Loop as long as the _outPos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
-			// Interpolate
-			st_sample_t inL, inR;
-			inL = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			inR = (inStereo ?
-						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						inL);
-
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
-
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-				outBuffer += 1;
+				// Increment output position
+				_outPosFrac += outPos_inc;
 			}
-
-			// Increment output position
-			_outPosFrac += outPos_inc;
 		}
+
+		outBuffer += mix(outBuffer, mixBuffer, (mixPos - mixBuffer) / (inStereo ? 2 : 1), volL, volR);
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
@@ -280,7 +271,8 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_inCurL(0),
 	_inCurR(0),
 	_bufferSize(0),
-	_bufferPos(nullptr) {}
+	_bufferPos(nullptr),
+	_mixFunc(RateMix::getMixFunc(inStereo, outStereo, reverseStereo)) {}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
@@ -297,7 +289,47 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 	}
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+namespace {
+
+struct RateMixImpl_Generic {
+	template<bool inStereo, bool outStereo, bool reverseStereo>
+	static void mix(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+		RateMix::mixGeneric<inStereo, outStereo, reverseStereo>(out, in, numFrames, volL, volR);
+	}
+};
+
+} // End of anonymous namespace
+
+RateMix::MixFunc RateMix::getMixFuncGeneric(bool inStereo, bool outStereo, bool reverseStereo) {
+	return selectMixFunc<RateMixImpl_Generic>(inStereo, outStereo, reverseStereo);
+}
+
+RateMix::MixFunc RateMix::getMixFunc(bool inStereo, bool outStereo, bool reverseStereo) {
+	MixFunc mixFunc = getMixFuncGeneric(inStereo, outStereo, reverseStereo);
+
+	// The SIMD versions rely on the mixer volume being a power of two and
+	// don't know about the unsigned output format
+#ifndef OUTPUT_UNSIGNED_AUDIO
+	STATIC_ASSERT(Audio::Mixer::kMaxMixerVolume == 256, SIMD_mixers_need_kMaxMixerVolume_256);
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) mixFunc = getMixFuncNEON(inStereo, outStereo, reverseStereo);
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) mixFunc = getMixFuncSSE2(inStereo, outStereo, reverseStereo);
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) mixFunc = getMixFuncAVX2(inStereo, outStereo, reverseStereo);
+#endif
+#endif // OUTPUT_UNSIGNED_AUDIO
+
+	return mixFunc;
+}
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterType type) {
+	if (type == kRateConverterSinc)
+		return makeSincRateConverter(inRate, outRate, inStereo, outStereo, reverseStereo);
+
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
@@ -314,4 +346,10 @@ RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inSte
 	}
 }
 
+RateConverterType parseRateConverterType(const Common::String &name) {
+	if (name.equalsIgnoreCase("sinc"))
+		return kRateConverterSinc;
+	return kRateConverterLinear;
+}
+
 } // End of namespace Audio
@@ -23,6 +23,7 @@
 #define AUDIO_RATE_H
 
 #include "common/frac.h"
+#include "common/str.h"
 
 namespace Audio {
 /**
@@ -104,7 +105,35 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+/**
+ * The algorithms makeRateConverter() can use for the sample rate conversion.
+ */
+enum RateConverterType {
+	/**
+	 * Point sampling for integral downsampling ratios and linear
+	 * interpolation otherwise. Cheap, but aliases audibly when upsampling
+	 * low rate audio.
+	 */
+	kRateConverterLinear,
+
+	/**
+	 * Band-limited polyphase windowed-sinc filter. The filter bank for a
+	 * given pair of rates is computed once and shared by all converters
+	 * using it.
+	 */
+	kRateConverterSinc
+};
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterType type = kRateConverterLinear);
+
+/**
+ * Parse the value of the "audio_resampler" config key.
+ *
+ * The key defaults to "linear", since the sinc filter costs much more CPU
+ * time. Backends for fast enough hardware can make it their default with
+ * ConfMan.registerDefault() before they create the mixer.
+ */
+RateConverterType parseRateConverterType(const Common::String &name);
 
 /** @} */
 } // End of namespace Audio
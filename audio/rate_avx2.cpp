@@ -0,0 +1,113 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+class RateMixImpl_AVX2 {
+	// Multiply the samples by the volume and divide by kMaxMixerVolume,
+	// truncating towards zero like the integer division in mixGeneric().
+	// Unpacking and packing both work per 128-bit lane, so the sample
+	// order is preserved.
+	static FORCEINLINE __m256i scale(__m256i in, __m256i vol) {
+		__m256i lo = _mm256_mullo_epi16(in, vol);
+		__m256i hi = _mm256_mulhi_epi16(in, vol);
+		__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+		__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+		p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_srli_epi32(_mm256_srai_epi32(p0, 31), 24)), 8);
+		p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_srli_epi32(_mm256_srai_epi32(p1, 31), 24)), 8);
+		return _mm256_packs_epi32(p0, p1);
+	}
+
+	// (left + right) / 2 for each frame, as 32-bit values
+	static FORCEINLINE __m256i downmix(__m256i frames) {
+		__m256i sum = _mm256_madd_epi16(frames, _mm256_set1_epi16(1));
+		return _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_srli_epi32(sum, 31)), 1);
+	}
+
+	static FORCEINLINE __m256i swapChannels(__m256i frames) {
+		return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(frames, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+	}
+
+public:
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void mix(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m256i vol = reverseStereo ? _mm256_set1_epi32((volL << 16) | volR) : _mm256_set1_epi32((volR << 16) | volL);
+
+	for (; numFrames >= 16; numFrames -= 16) {
+		__m256i frames0, frames1;
+		if (inStereo) {
+			frames0 = _mm256_loadu_si256((const __m256i *)in);
+			frames1 = _mm256_loadu_si256((const __m256i *)(in + 16));
+			in += 32;
+
+			if (reverseStereo) {
+				frames0 = swapChannels(frames0);
+				frames1 = swapChannels(frames1);
+			}
+		} else {
+			__m256i samples = _mm256_loadu_si256((const __m256i *)in);
+			__m256i lo = _mm256_unpacklo_epi16(samples, samples);
+			__m256i hi = _mm256_unpackhi_epi16(samples, samples);
+			frames0 = _mm256_permute2x128_si256(lo, hi, 0x20);
+			frames1 = _mm256_permute2x128_si256(lo, hi, 0x31);
+			in += 16;
+		}
+
+		frames0 = scale(frames0, vol);
+		frames1 = scale(frames1, vol);
+
+		if (outStereo) {
+			_mm256_storeu_si256((__m256i *)out, _mm256_adds_epi16(_mm256_loadu_si256((const __m256i *)out), frames0));
+			_mm256_storeu_si256((__m256i *)(out + 16), _mm256_adds_epi16(_mm256_loadu_si256((const __m256i *)(out + 16)), frames1));
+			out += 32;
+		} else {
+			__m256i mono = _mm256_packs_epi32(downmix(frames0), downmix(frames1));
+			mono = _mm256_permute4x64_epi64(mono, _MM_SHUFFLE(3, 1, 2, 0));
+			_mm256_storeu_si256((__m256i *)out, _mm256_adds_epi16(_mm256_loadu_si256((const __m256i *)out), mono));
+			out += 16;
+		}
+	}
+
+	RateMix::mixGeneric<inStereo, outStereo, reverseStereo>(out, in, numFrames, volL, volR);
+}
+
+}; // End of class RateMixImpl_AVX2
+
+RateMix::MixFunc RateMix::getMixFuncAVX2(bool inStereo, bool outStereo, bool reverseStereo) {
+	return selectMixFunc<RateMixImpl_AVX2>(inStereo, outStereo, reverseStereo);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Volume scaling and saturated mixing of already resampled frames into the
+ * mixer output buffer. This is the part of the rate conversion which runs
+ * for every output sample of every channel, so it has SIMD implementations
+ * which are selected at runtime, in the same way as Graphics::BlendBlit.
+ *
+ * All implementations must produce output identical to mixGeneric().
+ */
+class RateMix {
+public:
+	/**
+	 * Mix @p numFrames frames from @p in into @p out.
+	 *
+	 * @p in holds interleaved stereo frames if the converter input is stereo,
+	 * mono samples otherwise; @p out is in the converter output format.
+	 */
+	typedef void (*MixFunc)(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR);
+
+	/**
+	 * Return the fastest mix function supported by the CPU for the given
+	 * channel layout.
+	 */
+	static MixFunc getMixFunc(bool inStereo, bool outStereo, bool reverseStereo);
+
+	static MixFunc getMixFuncGeneric(bool inStereo, bool outStereo, bool reverseStereo);
+#ifdef SCUMMVM_NEON
+	static MixFunc getMixFuncNEON(bool inStereo, bool outStereo, bool reverseStereo);
+#endif
+#ifdef SCUMMVM_SSE2
+	static MixFunc getMixFuncSSE2(bool inStereo, bool outStereo, bool reverseStereo);
+#endif
+#ifdef SCUMMVM_AVX2
+	static MixFunc getMixFuncAVX2(bool inStereo, bool outStereo, bool reverseStereo);
+#endif
+
+	/**
+	 * The reference implementation. The SIMD versions use it to mix the
+	 * frames which don't fill a whole vector.
+	 */
+	template<bool inStereo, bool outStereo, bool reverseStereo>
+	static void mixGeneric(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+		for (; numFrames > 0; --numFrames) {
+			st_sample_t inL, inR;
+			inL = *in++;
+			inR = (inStereo ? *in++ : inL);
+
+			st_sample_t outL, outR;
+			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+			if (outStereo) {
+				// Output left channel
+				clampedAdd(out[reverseStereo    ], outL);
+
+				// Output right channel
+				clampedAdd(out[reverseStereo ^ 1], outR);
+
+				out += 2;
+			} else {
+				// Output mono channel
+				clampedAdd(out[0], (outL + outR) / 2);
+
+				out += 1;
+			}
+		}
+	}
+
+	/**
+	 * Helper for the SIMD implementations: returns the instantiation of
+	 * @p Impl::mix matching the given channel layout.
+	 */
+	template<class Impl>
+	static MixFunc selectMixFunc(bool inStereo, bool outStereo, bool reverseStereo) {
+		if (inStereo) {
+			if (outStereo) {
+				if (reverseStereo)
+					return &Impl::template mix<true, true, true>;
+				else
+					return &Impl::template mix<true, true, false>;
+			} else
+				return &Impl::template mix<true, false, false>;
+		} else {
+			if (outStereo)
+				return &Impl::template mix<false, true, false>;
+			else
+				return &Impl::template mix<false, false, false>;
+		}
+	}
+};
+
+RateConverter *makeSincRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+
+} // End of namespace Audio
+
+#endif
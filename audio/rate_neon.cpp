@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Audio {
+
+class RateMixImpl_NEON {
+	// Divide by kMaxMixerVolume, truncating towards zero like the integer
+	// division in mixGeneric()
+	static FORCEINLINE int32x4_t divVolume(int32x4_t p) {
+		uint32x4_t bias = vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24);
+		return vshrq_n_s32(vaddq_s32(p, vreinterpretq_s32_u32(bias)), 8);
+	}
+
+	static FORCEINLINE int16x8_t scale(int16x8_t in, int16x8_t vol) {
+		int32x4_t p0 = divVolume(vmull_s16(vget_low_s16(in), vget_low_s16(vol)));
+		int32x4_t p1 = divVolume(vmull_s16(vget_high_s16(in), vget_high_s16(vol)));
+		return vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1));
+	}
+
+	// (left + right) / 2 for each frame
+	static FORCEINLINE int16x4_t downmix(int16x8_t frames) {
+		int32x4_t sum = vpaddlq_s16(frames);
+		sum = vshrq_n_s32(vaddq_s32(sum, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(sum), 31))), 1);
+		return vqmovn_s32(sum);
+	}
+
+public:
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void mix(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const int16x8_t vol = vreinterpretq_s16_u32(reverseStereo ? vdupq_n_u32((volL << 16) | volR) : vdupq_n_u32((volR << 16) | volL));
+
+	for (; numFrames >= 8; numFrames -= 8) {
+		int16x8_t frames0, frames1;
+		if (inStereo) {
+			frames0 = vld1q_s16(in);
+			frames1 = vld1q_s16(in + 8);
+			in += 16;
+
+			if (reverseStereo) {
+				frames0 = vrev32q_s16(frames0);
+				frames1 = vrev32q_s16(frames1);
+			}
+		} else {
+			int16x8_t samples = vld1q_s16(in);
+			int16x8x2_t dup = vzipq_s16(samples, samples);
+			frames0 = dup.val[0];
+			frames1 = dup.val[1];
+			in += 8;
+		}
+
+		frames0 = scale(frames0, vol);
+		frames1 = scale(frames1, vol);
+
+		if (outStereo) {
+			vst1q_s16(out, vqaddq_s16(vld1q_s16(out), frames0));
+			vst1q_s16(out + 8, vqaddq_s16(vld1q_s16(out + 8), frames1));
+			out += 16;
+		} else {
+			int16x8_t mono = vcombine_s16(downmix(frames0), downmix(frames1));
+			vst1q_s16(out, vqaddq_s16(vld1q_s16(out), mono));
+			out += 8;
+		}
+	}
+
+	RateMix::mixGeneric<inStereo, outStereo, reverseStereo>(out, in, numFrames, volL, volR);
+}
+
+}; // End of class RateMixImpl_NEON
+
+RateMix::MixFunc RateMix::getMixFuncNEON(bool inStereo, bool outStereo, bool reverseStereo) {
+	return selectMixFunc<RateMixImpl_NEON>(inStereo, outStereo, reverseStereo);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif // __GNUC__
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,443 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/math.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/util.h"
+
+namespace Audio {
+
+/**
+ * The polyphase filter bank used to convert between one pair of sample rates.
+ *
+ * The ratio inRate / outRate is reduced to M / L. Output sample n is located
+ * at input position n * M / L, which is tracked as an integer input position
+ * plus a phase numerator in the range 0 .. L - 1. Each phase has its own set
+ * of filter taps, so converting a sample is a single dot product. When L is
+ * too large, the phases are quantised to kMaxPhases steps.
+ *
+ * The filter taps are windowed-sinc low-pass filters with the cutoff at the
+ * lower of the two Nyquist frequencies, so downsampling gets proportionally
+ * more taps (up to kMaxTaps). All math is done once at construction, the
+ * coefficients are stored as 16-bit fixed point numbers.
+ */
+class SincFilterBank {
+public:
+	enum {
+		kCoefBits = 14,
+		kZeroCrossings = 8,
+		kMaxTaps = 64,
+		kMaxPhases = 1024
+	};
+
+	SincFilterBank(st_rate_t inRate, st_rate_t outRate);
+
+	st_rate_t getInputRate() const { return _inRate; }
+	st_rate_t getOutputRate() const { return _outRate; }
+
+	uint getNumTaps() const { return _numTaps; }
+	uint getHalfTaps() const { return _numTaps / 2; }
+
+	/** Whether the rates are equal, in which case no filtering is needed */
+	bool isIdentity() const { return _inRate == _outRate; }
+
+	/** Whole input frames to advance for each output frame */
+	uint32 getInputStep() const { return _inputStep; }
+	/** Phase numerator to advance for each output frame */
+	uint32 getPhaseStep() const { return _phaseStep; }
+	/** Denominator of the phase, i.e. the reduced output rate */
+	uint32 getPhaseDenominator() const { return _phaseDen; }
+
+	const int16 *getTaps(uint32 phaseNum) const {
+		// Quantised phases use a 32.32 fixed point scale, so that no
+		// division is done per output frame
+		const uint phase = (_numPhases == _phaseDen) ? phaseNum : (uint)(((uint64)phaseNum * _phaseScale) >> 32);
+		return &_coefs[phase * _numTaps];
+	}
+
+	int _refCount;
+
+private:
+	st_rate_t _inRate, _outRate;
+	uint _numTaps;
+	uint _numPhases;
+	uint32 _inputStep, _phaseStep, _phaseDen;
+	uint64 _phaseScale;
+	Common::Array<int16> _coefs;
+};
+
+static double besselI0(double x) {
+	// Power series, converges quickly for the arguments used by the window
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; ++k) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+SincFilterBank::SincFilterBank(st_rate_t inRate, st_rate_t outRate) : _refCount(0), _inRate(inRate), _outRate(outRate) {
+	assert(inRate > 0 && outRate > 0);
+
+	const uint32 divisor = Common::gcd(inRate, outRate);
+	const uint32 m = inRate / divisor;
+	_phaseDen = outRate / divisor;
+	_inputStep = m / _phaseDen;
+	_phaseStep = m % _phaseDen;
+	_numPhases = MIN<uint32>(_phaseDen, kMaxPhases);
+	_phaseScale = ((uint64)_numPhases << 32) / _phaseDen;
+
+	// Cutoff relative to the input Nyquist frequency. Leave a small
+	// transition band below the output Nyquist frequency when resampling.
+	double cutoff = 1.0;
+	if (inRate != outRate)
+		cutoff = 0.92 * MIN(1.0, (double)outRate / inRate);
+
+	const uint halfTaps = isIdentity() ? 1 : MIN<uint>(kMaxTaps / 2, (uint)ceil(kZeroCrossings / MIN(1.0, (double)outRate / inRate)));
+	_numTaps = halfTaps * 2;
+
+	const double beta = 8.0;
+	const double windowScale = 1.0 / besselI0(beta);
+
+	_coefs.resize(_numPhases * _numTaps);
+
+	double taps[kMaxTaps];
+	for (uint phase = 0; phase < _numPhases; ++phase) {
+		const double offset = (double)phase / _numPhases;
+		double sum = 0.0;
+
+		// Tap t is applied to input frame (position + t - halfTaps + 1)
+		for (uint t = 0; t < _numTaps; ++t) {
+			const double x = (double)t - (halfTaps - 1) - offset;
+			const double ratio = x / halfTaps;
+
+			double value = 0.0;
+			if (ratio > -1.0 && ratio < 1.0) {
+				const double arg = M_PI * cutoff * x;
+				const double sinc = (fabs(arg) < 1e-9) ? 1.0 : sin(arg) / arg;
+				value = cutoff * sinc * besselI0(beta * sqrt(1.0 - ratio * ratio)) * windowScale;
+			}
+
+			taps[t] = value;
+			sum += value;
+		}
+
+		// Normalise to unity DC gain, so silence stays silent and a constant
+		// signal doesn't ripple between the phases
+		int16 *coefs = &_coefs[phase * _numTaps];
+		for (uint t = 0; t < _numTaps; ++t)
+			coefs[t] = (int16)floor(taps[t] / sum * (1 << kCoefBits) + 0.5);
+	}
+}
+
+/**
+ * Cache of the filter banks in use, so that all channels converting between
+ * the same rates share one set of tables. Banks are reference counted and
+ * freed once the last converter using them is gone.
+ */
+class SincFilterCache : public Common::Singleton<SincFilterCache> {
+public:
+	SincFilterBank *acquire(st_rate_t inRate, st_rate_t outRate) {
+		Common::StackLock lock(_mutex);
+
+		SincFilterBank *bank = nullptr;
+		for (uint i = 0; i < _banks.size(); ++i) {
+			if (_banks[i]->getInputRate() == inRate && _banks[i]->getOutputRate() == outRate) {
+				bank = _banks[i];
+				break;
+			}
+		}
+
+		if (!bank) {
+			bank = new SincFilterBank(inRate, outRate);
+			_banks.push_back(bank);
+		}
+
+		bank->_refCount++;
+		return bank;
+	}
+
+	void release(SincFilterBank *bank) {
+		Common::StackLock lock(_mutex);
+
+		if (--bank->_refCount > 0)
+			return;
+
+		for (uint i = 0; i < _banks.size(); ++i) {
+			if (_banks[i] == bank) {
+				_banks.remove_at(i);
+				break;
+			}
+		}
+		delete bank;
+	}
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	SincFilterCache() {}
+	~SincFilterCache() {
+		for (uint i = 0; i < _banks.size(); ++i)
+			delete _banks[i];
+	}
+
+	Common::Mutex _mutex;
+	Common::Array<SincFilterBank *> _banks;
+};
+
+} // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::SincFilterCache);
+}
+
+namespace Audio {
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+class SincRateConverter_Impl : public RateConverter {
+private:
+	enum {
+		kChannels = inStereo ? 2 : 1,
+		/** Number of input frames read from the stream at once */
+		kBlockFrames = 512,
+		/**
+		 * The window holds a block plus the filter history, and has room to
+		 * realign the history when the number of taps changes.
+		 */
+		kWindowFrames = kBlockFrames + 2 * SincFilterBank::kMaxTaps
+	};
+
+	SincFilterBank *_bank;
+
+	/** Input frames the filter is applied to */
+	st_sample_t _window[kWindowFrames * kChannels];
+
+	/** Index of the first frame used by the next output frame */
+	int _windowStart;
+
+	/** Number of frames loaded into the window */
+	int _windowEnd;
+
+	/** Fractional position of the next output frame, in 1 / _bank->getPhaseDenominator() units */
+	uint32 _phaseNum;
+
+	/** Whether the filter history has been flushed at the end of the stream */
+	bool _flushed;
+
+	RateMix::MixFunc _mixFunc;
+
+	void setBank(st_rate_t inRate, st_rate_t outRate);
+	bool fillWindow(AudioStream &input);
+
+public:
+	SincRateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
+	~SincRateConverter_Impl() override;
+
+	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
+
+	void setInputRate(st_rate_t inputRate) override { setBank(inputRate, _bank->getOutputRate()); }
+	void setOutputRate(st_rate_t outputRate) override { setBank(_bank->getInputRate(), outputRate); }
+
+	st_rate_t getInputRate() const override { return _bank->getInputRate(); }
+	st_rate_t getOutputRate() const override { return _bank->getOutputRate(); }
+
+	bool needsDraining() const override {
+		// Before the end of the stream, any frame not yet at the center of
+		// the filter still has to be output
+		if (!_flushed)
+			return _windowEnd > _windowStart + (int)_bank->getHalfTaps() - 1;
+		return _windowStart + (int)_bank->getNumTaps() <= _windowEnd;
+	}
+};
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+SincRateConverter_Impl<inStereo, outStereo, reverseStereo>::SincRateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate) :
+	_bank(SincFilterCache::instance().acquire(inputRate, outputRate)),
+	_windowStart(0),
+	_windowEnd(0),
+	_phaseNum(0),
+	_flushed(false),
+	_mixFunc(RateMix::getMixFunc(inStereo, outStereo, reverseStereo)) {
+
+	// Prime the history, so that the first output frame is centered on the
+	// first input frame
+	_windowEnd = _bank->getHalfTaps() - 1;
+	memset(_window, 0, sizeof(_window));
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+SincRateConverter_Impl<inStereo, outStereo, reverseStereo>::~SincRateConverter_Impl() {
+	SincFilterCache::instance().release(_bank);
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+void SincRateConverter_Impl<inStereo, outStereo, reverseStereo>::setBank(st_rate_t inRate, st_rate_t outRate) {
+	SincFilterBank *oldBank = _bank;
+	if (inRate == oldBank->getInputRate() && outRate == oldBank->getOutputRate())
+		return;
+
+	_bank = SincFilterCache::instance().acquire(inRate, outRate);
+
+	// Keep the current output position centered when the number of taps changes
+	_windowStart += (int)oldBank->getHalfTaps() - (int)_bank->getHalfTaps();
+	if (_windowStart < 0) {
+		const int shift = -_windowStart;
+		memmove(&_window[shift * kChannels], _window, _windowEnd * kChannels * sizeof(st_sample_t));
+		memset(_window, 0, shift * kChannels * sizeof(st_sample_t));
+		_windowStart = 0;
+		_windowEnd += shift;
+	}
+
+	_phaseNum = (uint32)(((uint64)_phaseNum * _bank->getPhaseDenominator()) / oldBank->getPhaseDenominator());
+
+	SincFilterCache::instance().release(oldBank);
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+bool SincRateConverter_Impl<inStereo, outStereo, reverseStereo>::fillWindow(AudioStream &input) {
+	// Move the frames still needed to the start of the window. When
+	// downsampling, the next output frame may start beyond the loaded data.
+	if (_windowStart >= _windowEnd) {
+		_windowStart -= _windowEnd;
+		_windowEnd = 0;
+	} else if (_windowStart > 0) {
+		memmove(_window, &_window[_windowStart * kChannels], (_windowEnd - _windowStart) * kChannels * sizeof(st_sample_t));
+		_windowEnd -= _windowStart;
+		_windowStart = 0;
+	}
+
+	const int space = kBlockFrames + SincFilterBank::kMaxTaps - _windowEnd;
+	int numSamples = (space > 0) ? input.readBuffer(&_window[_windowEnd * kChannels], space * kChannels) : 0;
+
+	if (numSamples <= 0) {
+		if (_flushed || !input.endOfStream())
+			return false;
+
+		// Feed silence through the filter, so the tail of the stream
+		// gets output as well
+		const int numFrames = _bank->getHalfTaps();
+		memset(&_window[_windowEnd * kChannels], 0, numFrames * kChannels * sizeof(st_sample_t));
+		_windowEnd += numFrames;
+		_flushed = true;
+		return true;
+	}
+
+	_windowEnd += numSamples / kChannels;
+	return true;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int SincRateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	assert(input.isStereo() == inStereo);
+
+	st_sample_t *outStart, *outEnd;
+	outStart = outBuffer;
+	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+
+	const int numTaps = _bank->getNumTaps();
+	const uint32 inputStep = _bank->getInputStep();
+	const uint32 phaseStep = _bank->getPhaseStep();
+	const uint32 phaseDen = _bank->getPhaseDenominator();
+
+	// The filtered frames are collected here, then mixed in one go
+	st_sample_t mixBuffer[kBlockFrames * kChannels];
+	bool endOfInput = false;
+
+	while (outBuffer < outEnd && !endOfInput) {
+		st_sample_t *mixPos = mixBuffer;
+		st_sample_t *mixEnd = mixBuffer + MIN<st_size_t>(kBlockFrames, (outEnd - outBuffer) / (outStereo ? 2 : 1)) * kChannels;
+
+		while (mixPos < mixEnd) {
+			if (_windowStart + numTaps > _windowEnd) {
+				if (!fillWindow(input)) {
+					endOfInput = true;
+					break;
+				}
+				continue;
+			}
+
+			const st_sample_t *in = &_window[_windowStart * kChannels];
+
+			if (_bank->isIdentity()) {
+				// Rates match, output the frame at the filter center
+				*mixPos++ = in[0];
+				if (inStereo)
+					*mixPos++ = in[1];
+			} else {
+				const int16 *taps = _bank->getTaps(_phaseNum);
+				int32 accL = 0, accR = 0;
+				for (int t = 0; t < numTaps; ++t) {
+					accL += in[t * kChannels] * taps[t];
+					if (inStereo)
+						accR += in[t * kChannels + 1] * taps[t];
+				}
+
+				*mixPos++ = (st_sample_t)CLIP<int32>((accL + (1 << (SincFilterBank::kCoefBits - 1))) >> SincFilterBank::kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+				if (inStereo)
+					*mixPos++ = (st_sample_t)CLIP<int32>((accR + (1 << (SincFilterBank::kCoefBits - 1))) >> SincFilterBank::kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+			}
+
+			// Advance to the next output position
+			_windowStart += inputStep;
+			_phaseNum += phaseStep;
+			if (_phaseNum >= phaseDen) {
+				_phaseNum -= phaseDen;
+				_windowStart++;
+			}
+		}
+
+		const st_size_t numFrames = (mixPos - mixBuffer) / kChannels;
+		if (volL > Audio::Mixer::kMaxMixerVolume || volR > Audio::Mixer::kMaxMixerVolume)
+			RateMix::mixGeneric<inStereo, outStereo, reverseStereo>(outBuffer, mixBuffer, numFrames, volL, volR);
+		else
+			_mixFunc(outBuffer, mixBuffer, numFrames, volL, volR);
+		outBuffer += numFrames * (outStereo ? 2 : 1);
+	}
+
+	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+}
+
+RateConverter *makeSincRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				return new SincRateConverter_Impl<true, true, true>(inRate, outRate);
+			else
+				return new SincRateConverter_Impl<true, true, false>(inRate, outRate);
+		} else
+			return new SincRateConverter_Impl<true, false, false>(inRate, outRate);
+	} else {
+		if (outStereo) {
+			return new SincRateConverter_Impl<false, true, false>(inRate, outRate);
+		} else
+			return new SincRateConverter_Impl<false, false, false>(inRate, outRate);
+	}
+}
+
+} // End of namespace Audio
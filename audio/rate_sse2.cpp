@@ -0,0 +1,112 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Audio {
+
+class RateMixImpl_SSE2 {
+	// Multiply the samples by the volume and divide by kMaxMixerVolume,
+	// truncating towards zero like the integer division in mixGeneric()
+	static FORCEINLINE __m128i scale(__m128i in, __m128i vol) {
+		__m128i lo = _mm_mullo_epi16(in, vol);
+		__m128i hi = _mm_mulhi_epi16(in, vol);
+		__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+		__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+		p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_srli_epi32(_mm_srai_epi32(p0, 31), 24)), 8);
+		p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_srli_epi32(_mm_srai_epi32(p1, 31), 24)), 8);
+		return _mm_packs_epi32(p0, p1);
+	}
+
+	// (left + right) / 2 for each frame, as 32-bit values
+	static FORCEINLINE __m128i downmix(__m128i frames) {
+		__m128i sum = _mm_madd_epi16(frames, _mm_set1_epi16(1));
+		return _mm_srai_epi32(_mm_add_epi32(sum, _mm_srli_epi32(sum, 31)), 1);
+	}
+
+	static FORCEINLINE __m128i swapChannels(__m128i frames) {
+		return _mm_shufflehi_epi16(_mm_shufflelo_epi16(frames, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+	}
+
+public:
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void mix(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m128i vol = reverseStereo ? _mm_set1_epi32((volL << 16) | volR) : _mm_set1_epi32((volR << 16) | volL);
+
+	for (; numFrames >= 8; numFrames -= 8) {
+		__m128i frames0, frames1;
+		if (inStereo) {
+			frames0 = _mm_loadu_si128((const __m128i *)in);
+			frames1 = _mm_loadu_si128((const __m128i *)(in + 8));
+			in += 16;
+
+			if (reverseStereo) {
+				frames0 = swapChannels(frames0);
+				frames1 = swapChannels(frames1);
+			}
+		} else {
+			__m128i samples = _mm_loadu_si128((const __m128i *)in);
+			frames0 = _mm_unpacklo_epi16(samples, samples);
+			frames1 = _mm_unpackhi_epi16(samples, samples);
+			in += 8;
+		}
+
+		frames0 = scale(frames0, vol);
+		frames1 = scale(frames1, vol);
+
+		if (outStereo) {
+			_mm_storeu_si128((__m128i *)out, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)out), frames0));
+			_mm_storeu_si128((__m128i *)(out + 8), _mm_adds_epi16(_mm_loadu_si128((const __m128i *)(out + 8)), frames1));
+			out += 16;
+		} else {
+			__m128i mono = _mm_packs_epi32(downmix(frames0), downmix(frames1));
+			_mm_storeu_si128((__m128i *)out, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)out), mono));
+			out += 8;
+		}
+	}
+
+	RateMix::mixGeneric<inStereo, outStereo, reverseStereo>(out, in, numFrames, volL, volR);
+}
+
+}; // End of class RateMixImpl_SSE2
+
+RateMix::MixFunc RateMix::getMixFuncSSE2(bool inStereo, bool outStereo, bool reverseStereo) {
+	return selectMixFunc<RateMixImpl_SSE2>(inStereo, outStereo, reverseStereo);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -185,7 +185,6 @@ static const Bit8u ch_slot[18] = {
 // Envelope generator
 //
 
-typedef Bit16s(*envelope_sinfunc)(Bit16u phase, Bit16u envelope);
 typedef void(*envelope_genfunc)(opl3_slot *slott);
 
 static Bit16s OPL3_EnvelopeCalcExp(Bit32u level)
@@ -197,14 +196,24 @@ static Bit16s OPL3_EnvelopeCalcExp(Bit32u level)
     return (exprom[level & 0xff] << 1) >> (level >> 8);
 }
 
-static Bit16s OPL3_EnvelopeCalcSin0(Bit16u phase, Bit16u envelope)
+//
+// Waveforms
+//
+// The waveform functions return the log-sin attenuation for a phase, with
+// bit 15 set for the negative half-waves. OPL3_InitWaveTable() evaluates
+// them for all phases once, so that the slots only need a table lookup.
+//
+
+#define WAVE_NEG    0x8000
+
+static Bit16u OPL3_WaveLogSin0(Bit16u phase)
 {
     Bit16u out = 0;
     Bit16u neg = 0;
     phase &= 0x3ff;
     if (phase & 0x200)
     {
-        neg = 0xffff;
+        neg = WAVE_NEG;
     }
     if (phase & 0x100)
     {
@@ -214,10 +223,10 @@ static Bit16s OPL3_EnvelopeCalcSin0(Bit16u phase, Bit16u envelope)
     {
         out = logsinrom[phase & 0xff];
     }
-    return OPL3_EnvelopeCalcExp(out + (envelope << 3)) ^ neg;
+    return out | neg;
 }
 
-static Bit16s OPL3_EnvelopeCalcSin1(Bit16u phase, Bit16u envelope)
+static Bit16u OPL3_WaveLogSin1(Bit16u phase)
 {
     Bit16u out = 0;
     phase &= 0x3ff;
@@ -233,10 +242,10 @@ static Bit16s OPL3_EnvelopeCalcSin1(Bit16u phase, Bit16u envelope)
     {
         out = logsinrom[phase & 0xff];
     }
-    return OPL3_EnvelopeCalcExp(out + (envelope << 3));
+    return out;
 }
 
-static Bit16s OPL3_EnvelopeCalcSin2(Bit16u phase, Bit16u envelope)
+static Bit16u OPL3_WaveLogSin2(Bit16u phase)
 {
     Bit16u out = 0;
     phase &= 0x3ff;
@@ -248,10 +257,10 @@ static Bit16s OPL3_EnvelopeCalcSin2(Bit16u phase, Bit16u envelope)
     {
         out = logsinrom[phase & 0xff];
     }
-    return OPL3_EnvelopeCalcExp(out + (envelope << 3));
+    return out;
 }
 
-static Bit16s OPL3_EnvelopeCalcSin3(Bit16u phase, Bit16u envelope)
+static Bit16u OPL3_WaveLogSin3(Bit16u phase)
 {
     Bit16u out = 0;
     phase &= 0x3ff;
@@ -263,17 +272,17 @@ static Bit16s OPL3_EnvelopeCalcSin3(Bit16u phase, Bit16u envelope)
     {
         out = logsinrom[phase & 0xff];
     }
-    return OPL3_EnvelopeCalcExp(out + (envelope << 3));
+    return out;
 }
 
-static Bit16s OPL3_EnvelopeCalcSin4(Bit16u phase, Bit16u envelope)
+static Bit16u OPL3_WaveLogSin4(Bit16u phase)
 {
     Bit16u out = 0;
     Bit16u neg = 0;
     phase &= 0x3ff;
     if ((phase & 0x300) == 0x100)
     {
-        neg = 0xffff;
+        neg = WAVE_NEG;
     }
     if (phase & 0x200)
     {
@@ -287,10 +296,10 @@ static Bit16s OPL3_EnvelopeCalcSin4(Bit16u phase, Bit16u envelope)
     {
         out = logsinrom[(phase << 1) & 0xff];
     }
-    return OPL3_EnvelopeCalcExp(out + (envelope << 3)) ^ neg;
+    return out | neg;
 }
 
-static Bit16s OPL3_EnvelopeCalcSin5(Bit16u phase, Bit16u envelope)
+static Bit16u OPL3_WaveLogSin5(Bit16u phase)
 {
     Bit16u out = 0;
     phase &= 0x3ff;
@@ -306,45 +315,75 @@ static Bit16s OPL3_EnvelopeCalcSin5(Bit16u phase, Bit16u envelope)
     {
         out = logsinrom[(phase << 1) & 0xff];
     }
-    return OPL3_EnvelopeCalcExp(out + (envelope << 3));
+    return out;
 }
 
-static Bit16s OPL3_EnvelopeCalcSin6(Bit16u phase, Bit16u envelope)
+static Bit16u OPL3_WaveLogSin6(Bit16u phase)
 {
     Bit16u neg = 0;
     phase &= 0x3ff;
     if (phase & 0x200)
     {
-        neg = 0xffff;
+        neg = WAVE_NEG;
     }
-    return OPL3_EnvelopeCalcExp(envelope << 3) ^ neg;
+    return neg;
 }
 
-static Bit16s OPL3_EnvelopeCalcSin7(Bit16u phase, Bit16u envelope)
+static Bit16u OPL3_WaveLogSin7(Bit16u phase)
 {
     Bit16u out = 0;
     Bit16u neg = 0;
     phase &= 0x3ff;
     if (phase & 0x200)
     {
-        neg = 0xffff;
+        neg = WAVE_NEG;
         phase = (phase & 0x1ff) ^ 0x1ff;
     }
     out = phase << 3;
-    return OPL3_EnvelopeCalcExp(out + (envelope << 3)) ^ neg;
+    return out | neg;
 }
 
-static const envelope_sinfunc envelope_sin[8] = {
-    OPL3_EnvelopeCalcSin0,
-    OPL3_EnvelopeCalcSin1,
-    OPL3_EnvelopeCalcSin2,
-    OPL3_EnvelopeCalcSin3,
-    OPL3_EnvelopeCalcSin4,
-    OPL3_EnvelopeCalcSin5,
-    OPL3_EnvelopeCalcSin6,
-    OPL3_EnvelopeCalcSin7
+typedef Bit16u(*wave_logsinfunc)(Bit16u phase);
+
+static const wave_logsinfunc wave_logsin[8] = {
+    OPL3_WaveLogSin0,
+    OPL3_WaveLogSin1,
+    OPL3_WaveLogSin2,
+    OPL3_WaveLogSin3,
+    OPL3_WaveLogSin4,
+    OPL3_WaveLogSin5,
+    OPL3_WaveLogSin6,
+    OPL3_WaveLogSin7
 };
 
+static Bit16u wavetable[8][0x400];
+static bool wavetable_init = false;
+
+static void OPL3_InitWaveTable()
+{
+    Bit16u wf, phase;
+
+    if (wavetable_init)
+    {
+        return;
+    }
+    for (wf = 0; wf < 8; wf++)
+    {
+        for (phase = 0; phase < 0x400; phase++)
+        {
+            wavetable[wf][phase] = wave_logsin[wf](phase);
+        }
+    }
+    wavetable_init = true;
+}
+
+static inline Bit16s OPL3_EnvelopeCalcWave(Bit8u wf, Bit16u phase, Bit16u envelope)
+{
+    Bit16u out = wavetable[wf][phase & 0x3ff];
+    Bit16u neg = (Bit16u)-(out >> 15);
+    return OPL3_EnvelopeCalcExp((out & ~WAVE_NEG) + (envelope << 3)) ^ neg;
+}
+
 enum envelope_gen_num
 {
     envelope_gen_num_attack = 0,
@@ -364,7 +403,7 @@ static void OPL3_EnvelopeUpdateKSL(opl3_slot *slot)
     slot->eg_ksl = (Bit8u)ksl;
 }
 
-static void OPL3_EnvelopeCalc(opl3_slot *slot)
+static FORCEINLINE void OPL3_EnvelopeCalc(opl3_slot *slot)
 {
     Bit8u nonzero;
     Bit8u rate;
@@ -379,6 +418,24 @@ static void OPL3_EnvelopeCalc(opl3_slot *slot)
     Bit8u reset = 0;
     slot->eg_out = slot->eg_rout + (slot->reg_tl << 2)
                  + (slot->eg_ksl >> kslshift[slot->reg_ksl]) + *slot->trem;
+    // Fast paths for the two states most slots spend their time in. Released
+    // and fully attenuated: nothing changes until the next key on.
+    if (!slot->key && slot->eg_gen == envelope_gen_num_release && slot->eg_rout == 0x1ff)
+    {
+        slot->pg_reset = 0;
+        return;
+    }
+    // Held in sustain without decay: the level stays unless it is (almost)
+    // off.
+    if (slot->key && slot->eg_gen == envelope_gen_num_sustain && slot->reg_type)
+    {
+        slot->pg_reset = 0;
+        if ((slot->eg_rout & 0x1f8) == 0x1f8)
+        {
+            slot->eg_rout = 0x1ff;
+        }
+        return;
+    }
     if (slot->key && slot->eg_gen == envelope_gen_num_release)
     {
         reset = 1;
@@ -529,12 +586,30 @@ static void OPL3_EnvelopeKeyOff(opl3_slot *slot, Bit8u type)
 // Phase Generator
 //
 
-static void OPL3_PhaseGenerate(opl3_slot *slot)
+// The noise generator is a 23 bit LFSR which advances once per slot. Its new
+// bits only reach the tap at bit 14 after 8 steps, so up to 8 steps can be
+// taken at once.
+static Bit32u OPL3_NoiseAdvance(Bit32u noise, Bit8u steps)
+{
+    Bit8u n;
+    Bit32u n_bits;
+
+    while (steps)
+    {
+        n = steps > 8 ? 8 : steps;
+        n_bits = ((noise >> 14) ^ noise) & ((1 << n) - 1);
+        noise = (noise >> n) | (n_bits << (23 - n));
+        steps -= n;
+    }
+    return noise;
+}
+
+static FORCEINLINE void OPL3_PhaseGenerate(opl3_slot *slot)
 {
     opl3_chip *chip;
     Bit16u f_num;
     Bit32u basefreq;
-    Bit8u rm_xor, n_bit;
+    Bit8u rm_xor;
     Bit32u noise;
     Bit16u phase;
 
@@ -571,9 +646,12 @@ static void OPL3_PhaseGenerate(opl3_slot *slot)
         slot->pg_phase = 0;
     }
     slot->pg_phase += (basefreq * mt[slot->reg_mult]) >> 1;
-    // Rhythm mode
-    noise = chip->noise;
     slot->pg_phase_out = phase;
+    if (slot->slot_num < 13 || slot->slot_num > 17)
+    {
+        return;
+    }
+    // Rhythm mode
     if (slot->slot_num == 13) // hh
     {
         chip->rm_hh_bit2 = (phase >> 2) & 1;
@@ -591,9 +669,11 @@ static void OPL3_PhaseGenerate(opl3_slot *slot)
         rm_xor = (chip->rm_hh_bit2 ^ chip->rm_hh_bit7)
                | (chip->rm_hh_bit3 ^ chip->rm_tc_bit5)
                | (chip->rm_tc_bit3 ^ chip->rm_tc_bit5);
+        // chip->noise is the state at the start of the sample
         switch (slot->slot_num)
         {
         case 13: // hh
+            noise = OPL3_NoiseAdvance(chip->noise, 13);
             slot->pg_phase_out = rm_xor << 9;
             if (rm_xor ^ (noise & 1))
             {
@@ -605,6 +685,7 @@ static void OPL3_PhaseGenerate(opl3_slot *slot)
             }
             break;
         case 16: // sd
+            noise = OPL3_NoiseAdvance(chip->noise, 16);
             slot->pg_phase_out = (chip->rm_hh_bit8 << 9)
                                | ((chip->rm_hh_bit8 ^ (noise & 1)) << 8);
             break;
@@ -615,8 +696,6 @@ static void OPL3_PhaseGenerate(opl3_slot *slot)
             break;
         }
     }
-    n_bit = ((noise >> 14) ^ noise) & 0x01;
-    chip->noise = (noise >> 1) | (n_bit << 22);
 }
 
 //
@@ -671,12 +750,12 @@ static void OPL3_SlotWriteE0(opl3_slot *slot, Bit8u data)
     }
 }
 
-static void OPL3_SlotGenerate(opl3_slot *slot)
+static FORCEINLINE void OPL3_SlotGenerate(opl3_slot *slot)
 {
-    slot->out = envelope_sin[slot->reg_wf](slot->pg_phase_out + *slot->mod, slot->eg_out);
+    slot->out = OPL3_EnvelopeCalcWave(slot->reg_wf, slot->pg_phase_out + *slot->mod, slot->eg_out);
 }
 
-static void OPL3_SlotCalcFB(opl3_slot *slot)
+static FORCEINLINE void OPL3_SlotCalcFB(opl3_slot *slot)
 {
     if (slot->channel->fb != 0x00)
     {
@@ -1060,6 +1139,14 @@ static Bit16s OPL3_ClipSample(Bit32s sample)
     return (Bit16s)sample;
 }
 
+static FORCEINLINE void OPL3_SlotProcess(opl3_slot *slot)
+{
+    OPL3_SlotCalcFB(slot);
+    OPL3_EnvelopeCalc(slot);
+    OPL3_PhaseGenerate(slot);
+    OPL3_SlotGenerate(slot);
+}
+
 void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
 {
     Bit8u ii;
@@ -1071,10 +1158,7 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
 
     for (ii = 0; ii < 15; ii++)
     {
-        OPL3_SlotCalcFB(&chip->slot[ii]);
-        OPL3_EnvelopeCalc(&chip->slot[ii]);
-        OPL3_PhaseGenerate(&chip->slot[ii]);
-        OPL3_SlotGenerate(&chip->slot[ii]);
+        OPL3_SlotProcess(&chip->slot[ii]);
     }
 
     chip->mixbuff[0] = 0;
@@ -1090,20 +1174,14 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
 
     for (ii = 15; ii < 18; ii++)
     {
-        OPL3_SlotCalcFB(&chip->slot[ii]);
-        OPL3_EnvelopeCalc(&chip->slot[ii]);
-        OPL3_PhaseGenerate(&chip->slot[ii]);
-        OPL3_SlotGenerate(&chip->slot[ii]);
+        OPL3_SlotProcess(&chip->slot[ii]);
     }
 
     buf[0] = OPL3_ClipSample(chip->mixbuff[0]);
 
     for (ii = 18; ii < 33; ii++)
     {
-        OPL3_SlotCalcFB(&chip->slot[ii]);
-        OPL3_EnvelopeCalc(&chip->slot[ii]);
-        OPL3_PhaseGenerate(&chip->slot[ii]);
-        OPL3_SlotGenerate(&chip->slot[ii]);
+        OPL3_SlotProcess(&chip->slot[ii]);
     }
 
     chip->mixbuff[1] = 0;
@@ -1119,10 +1197,7 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
 
     for (ii = 33; ii < 36; ii++)
     {
-        OPL3_SlotCalcFB(&chip->slot[ii]);
-        OPL3_EnvelopeCalc(&chip->slot[ii]);
-        OPL3_PhaseGenerate(&chip->slot[ii]);
-        OPL3_SlotGenerate(&chip->slot[ii]);
+        OPL3_SlotProcess(&chip->slot[ii]);
     }
 
     if ((chip->timer & 0x3f) == 0x3f)
@@ -1145,6 +1220,8 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
 
     chip->timer++;
 
+    chip->noise = OPL3_NoiseAdvance(chip->noise, 36);
+
     chip->eg_add = 0;
     if (chip->eg_timer)
     {
@@ -1213,6 +1290,8 @@ void OPL3_Reset(opl3_chip *chip, Bit32u samplerate)
     Bit8u slotnum;
     Bit8u channum;
 
+    OPL3_InitWaveTable();
+
     memset(chip, 0, sizeof(opl3_chip));
     for (slotnum = 0; slotnum < 36; slotnum++)
     {
@@ -1498,7 +1577,7 @@ byte OPL::read(int port) {
 }
 
 void OPL::generateSamples(int16*buffer, int length) {
-	OPL3_GenerateStream(&chip, (Bit16s*)buffer, (Bit16u)length / 2);
+	OPL3_GenerateStream(&chip, (Bit16s*)buffer, (Bit32u)length / 2);
 }
 
 }
@@ -266,6 +266,12 @@ AbstractFSNode *POSIXFilesystemNode::getParent() const {
 }
 
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
+#ifdef HAS_MMAP
+	Common::SeekableReadStream *mapped = PosixMappedStream::makeFromPath(getPath());
+	if (mapped)
+		return mapped;
+#endif
+
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
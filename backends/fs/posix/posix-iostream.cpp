@@ -25,6 +25,12 @@
 
 #include <sys/stat.h>
 
+#ifdef HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 PosixIoStream *PosixIoStream::makeFromPath(const Common::String &path, bool writeMode) {
 #if defined(HAS_FOPEN64)
 	FILE *handle = fopen64(path.c_str(), writeMode ? "wb" : "rb");
@@ -58,3 +64,80 @@ int64 PosixIoStream::size() const {
 
 	return st.st_size;
 }
+
+#ifdef HAS_MMAP
+
+PosixMappedStream *PosixMappedStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size < kMinMappedSize ||
+			(sizeof(void *) < 8 && st.st_size > kMaxMappedSize32) || (int64)(size_t)st.st_size != (int64)st.st_size) {
+		close(fd);
+		return nullptr;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMappedStream((const byte *)data, st.st_size);
+}
+
+PosixMappedStream::PosixMappedStream(const byte *data, int64 size) :
+		_data(data), _size(size), _pos(0), _eos(false) {
+}
+
+PosixMappedStream::~PosixMappedStream() {
+	munmap(const_cast<byte *>(_data), _size);
+}
+
+uint32 PosixMappedStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	memcpy(dataPtr, _data + _pos, dataSize);
+	_pos += dataSize;
+
+	return dataSize;
+}
+
+bool PosixMappedStream::seek(int64 offset, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offset += _size;
+		break;
+	case SEEK_CUR:
+		offset += _pos;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offset < 0 || offset > _size)
+		return false;
+
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+const byte *PosixMappedStream::borrow(uint32 len) {
+	if (len > _size - _pos)
+		return nullptr;
+
+	const byte *data = _data + _pos;
+	_pos += len;
+
+	return data;
+}
+
+#endif
@@ -35,4 +35,58 @@ public:
 	int64 size() const override;
 };
 
+#ifdef HAS_MMAP
+
+/**
+ * A read-only file stream which maps the whole file into memory. Reads are
+ * plain memory copies and borrow() returns pointers into the mapping, so
+ * callers which opt into it read the file without any copying. The kernel
+ * pages the file in on demand and can drop clean pages under memory
+ * pressure, unlike with data read into heap buffers.
+ *
+ * POSIXFilesystemNode::createReadStream() uses it for all files of at least
+ * kMinMappedSize. Accessing the data raises SIGBUS if the file is truncated
+ * while it is mapped, which is fine for the game data files read with it.
+ */
+class PosixMappedStream final : public Common::SeekableReadStream {
+public:
+	/**
+	 * Files smaller than this are not worth mapping: the setup costs more
+	 * than the copying it saves.
+	 */
+	static const int64 kMinMappedSize = 64 * 1024;
+
+	/**
+	 * With 32-bit pointers, files bigger than this are not mapped, so that
+	 * a few of them can't use up the address space.
+	 */
+	static const int64 kMaxMappedSize32 = 64 * 1024 * 1024;
+
+	/**
+	 * Map the file at @p path, or return nullptr if it is smaller than
+	 * kMinMappedSize, too big for the address space or can't be mapped.
+	 */
+	static PosixMappedStream *makeFromPath(const Common::String &path);
+	~PosixMappedStream() override;
+
+	bool eos() const override { return _eos; }
+	void clearErr() override { _eos = false; }
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+	const byte *borrow(uint32 len) override;
+
+private:
+	PosixMappedStream(const byte *data, int64 size);
+
+	const byte *_data;
+	int64 _size;
+	int64 _pos;
+	bool _eos;
+};
+
+#endif
+
 #endif
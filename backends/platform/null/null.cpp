@@ -82,6 +82,8 @@ public:
 
 	virtual void initBackend();
 
+	virtual bool hasFeature(Feature f);
+
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual Common::MutexInternal *createMutex();
@@ -159,6 +161,27 @@ void OSystem_NULL::initBackend() {
 	BaseBackend::initBackend();
 }
 
+bool OSystem_NULL::hasFeature(Feature f) {
+	// Report the CPU features, so that benchmarks run with this backend
+	// use the same code paths as the real backends
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	if (f == kFeatureCpuSSE2)
+		return __builtin_cpu_supports("sse2");
+	if (f == kFeatureCpuAVX2)
+		return __builtin_cpu_supports("avx2");
+#endif
+#if defined(__aarch64__)
+	if (f == kFeatureCpuNEON)
+		return true;
+#endif
+
+	// Tests run without a graphics manager
+	if (!_graphicsManager)
+		return false;
+
+	return ModularGraphicsBackend::hasFeature(f);
+}
+
 bool OSystem_NULL::pollEvent(Common::Event &event) {
 #ifndef NULL_DRIVER_USE_FOR_TEST
 	((DefaultTimerManager *)getTimerManager())->checkTimers();
@@ -122,6 +122,10 @@ SeekableReadStream *Archive::createReadStreamForMemberAltStream(const Path &path
 	return nullptr;
 }
 
+AsyncReadHandle Archive::openAsync(const Path &path) const {
+	return AsyncReadHandle(createReadStreamForMember(path), false);
+}
+
 Common::Error Archive::dumpArchive(const Path &destPath) {
 	Common::ArchiveMemberList files;
 
@@ -371,6 +375,9 @@ void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPa
 void SearchSet::remove(const String &name) {
 	ArchiveNodeList::iterator it = find(name);
 	if (it != _list.end()) {
+		// Some of the prefetched files might be from this archive
+		_prefetched.clear();
+
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
@@ -391,6 +398,8 @@ Archive *SearchSet::getArchive(const String &name) const {
 }
 
 void SearchSet::clear() {
+	_prefetched.clear();
+
 	for (ArchiveNodeList::iterator i = _list.begin(); i != _list.end(); ++i) {
 		if (i->_autoFree)
 			delete i->_arc;
@@ -510,6 +519,18 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	if (!_prefetched.empty()) {
+		PrefetchMap::iterator prefetched = _prefetched.find(path);
+		if (prefetched != _prefetched.end()) {
+			AsyncReadHandle handle = prefetched->_value;
+			_prefetched.erase(prefetched);
+
+			SeekableReadStream *stream = handle.getStream();
+			if (stream)
+				return stream;
+		}
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
@@ -553,6 +574,28 @@ SeekableReadStream *SearchSet::createReadStreamForMemberNext(const Path &path, c
 	return nullptr;
 }
 
+AsyncReadHandle SearchSet::openAsync(const Path &path) const {
+	if (path.empty())
+		return AsyncReadHandle();
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		if (it->_arc->hasFile(path))
+			return it->_arc->openAsync(path);
+	}
+
+	return AsyncReadHandle();
+}
+
+void SearchSet::prefetch(const Path &path) {
+	if (_prefetched.contains(path))
+		return;
+
+	AsyncReadHandle handle = openAsync(path);
+	if (handle.isValid())
+		_prefetched[path] = handle;
+}
+
 SearchManager::SearchManager() {
 	clear(); // Force a reset
 }
@@ -27,6 +27,7 @@
 #include "common/hash-str.h"
 #include "common/list.h"
 #include "common/path.h"
+#include "common/prefetch.h"
 #include "common/ptr.h"
 #include "common/singleton.h"
 #include "common/str.h"
@@ -202,6 +203,19 @@ public:
 		return createReadStreamForMember(path);
 	}
 
+	/**
+	 * Start reading a member with the specified name in the background, so
+	 * that it is in memory by the time it is needed. See AsyncReadHandle for
+	 * how to get the data.
+	 *
+	 * Archives can only do this if their member streams are independent of
+	 * each other and of the archive, e.g. because they are separate files.
+	 * The default implementation just opens the member.
+	 *
+	 * @return The handle, which is invalid if no member with this name exists.
+	 */
+	virtual AsyncReadHandle openAsync(const Path &path) const;
+
 	/**
 	 * Dump all files from the archive to the given directory
 	 */
@@ -329,6 +343,9 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	typedef HashMap<Path, AsyncReadHandle, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualTo> PrefetchMap;
+	mutable PrefetchMap _prefetched;
+
 public:
 	SearchSet() : _ignoreClashes(false) { }
 	virtual ~SearchSet() { clear(); }
@@ -450,6 +467,21 @@ public:
 	 */
 	SeekableReadStream *createReadStreamForMemberNext(const Path &path, const Archive *starting) const override;
 
+	/**
+	 * Implement openAsync from the Archive base class, using the first archive
+	 * which has a member with the name.
+	 */
+	AsyncReadHandle openAsync(const Path &path) const override;
+
+	/**
+	 * Start reading a file in the background, e.g. for the next scene while
+	 * the current one is still running. The next createReadStreamForMember()
+	 * call for it, and thus File::open(), then returns the data read. Until
+	 * that, the data is kept in memory, or until clear() or remove() is
+	 * called.
+	 */
+	void prefetch(const Path &path);
+
 	/**
 	 * Ignore clashes when adding directories. For more details, see the corresponding parameter
 	 * in @ref FSDirectory documentation.
@@ -0,0 +1,146 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic operations
+ * @ingroup common
+ *
+ * @brief Minimal acquire/release operations on word sized variables.
+ *
+ * These are meant for handing data between a timer or audio callback and
+ * the main thread without taking a mutex, e.g. in single producer, single
+ * consumer queues. Code using them must check SCUMMVM_ATOMICS and fall back
+ * to Common::Mutex where it is not defined: in that case the functions are
+ * plain memory accesses.
+ *
+ * @{
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+
+#define SCUMMVM_ATOMICS
+
+/** Load @p *ptr; later memory accesses can't be moved before the load. */
+template<typename T>
+inline T atomicLoadAcquire(const T *ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+/** Store to @p *ptr; earlier memory accesses can't be moved after the store. */
+template<typename T>
+inline void atomicStoreRelease(T *ptr, T value) {
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+/** Add @p value to @p *ptr and return the new value, as a full barrier. */
+template<typename T>
+inline T atomicAdd(T *ptr, T value) {
+	return __atomic_add_fetch(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+/** Store @p value to @p *ptr and return the old value, as a full barrier. */
+template<typename T>
+inline T atomicExchange(T *ptr, T value) {
+	return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+#elif defined(_MSC_VER)
+
+#define SCUMMVM_ATOMICS
+
+#if defined(_M_ARM) || defined(_M_ARM64)
+#define SCUMMVM_ATOMIC_FENCE() __dmb(0xB)
+#else
+#define SCUMMVM_ATOMIC_FENCE() _ReadWriteBarrier()
+#endif
+
+template<typename T>
+inline T atomicLoadAcquire(const T *ptr) {
+	T value = *(const volatile T *)ptr;
+	SCUMMVM_ATOMIC_FENCE();
+	return value;
+}
+
+template<typename T>
+inline void atomicStoreRelease(T *ptr, T value) {
+	SCUMMVM_ATOMIC_FENCE();
+	*(volatile T *)ptr = value;
+}
+
+template<typename T>
+inline T atomicAdd(T *ptr, T value) {
+	STATIC_ASSERT(sizeof(T) == sizeof(long), atomicAdd_needs_long_sized_values);
+	return (T)_InterlockedExchangeAdd((volatile long *)ptr, (long)value) + value;
+}
+
+template<typename T>
+inline T atomicExchange(T *ptr, T value) {
+	STATIC_ASSERT(sizeof(T) == sizeof(long), atomicExchange_needs_long_sized_values);
+	return (T)_InterlockedExchange((volatile long *)ptr, (long)value);
+}
+
+#undef SCUMMVM_ATOMIC_FENCE
+
+#else
+
+// No atomic operations for this compiler. These plain versions are only
+// correct if all accesses are protected by a mutex anyway.
+
+template<typename T>
+inline T atomicLoadAcquire(const T *ptr) {
+	return *ptr;
+}
+
+template<typename T>
+inline void atomicStoreRelease(T *ptr, T value) {
+	*ptr = value;
+}
+
+template<typename T>
+inline T atomicAdd(T *ptr, T value) {
+	return *ptr += value;
+}
+
+template<typename T>
+inline T atomicExchange(T *ptr, T value) {
+	T old = *ptr;
+	*ptr = value;
+	return old;
+}
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
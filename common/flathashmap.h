@@ -0,0 +1,612 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The hash map in this file uses Robin Hood hashing with linear probing and
+// backward shift deletion.
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/hashmap.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a hash table which stores its elements inline.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a replacement for HashMap<Key,Val> with the same
+ * interface, which is faster for lookups and iteration.
+ *
+ * HashMap stores pointers to separately allocated nodes, so every lookup
+ * dereferences a pointer to a random location. FlatHashMap stores the nodes
+ * in the table itself, next to an array with one byte per slot, which holds
+ * the distance of the node from the slot its hash points to, or 0 if the slot
+ * is empty. Lookups mostly touch these bytes, and as nodes are kept sorted
+ * by that distance (Robin Hood hashing), a lookup for a missing key ends
+ * after a few slots. Erasing moves the following nodes back, so there are
+ * no deleted markers to skip.
+ *
+ * The differences to HashMap are:
+ * - Inserting and erasing elements moves other elements, so it invalidates
+ *   all iterators, pointers and references to elements.
+ * - Hence erasing elements while iterating over the map is not supported.
+ * - The keys in Node are not const, but must not be modified.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node(Node &&node) : _value(Common::move(node._value)), _key(Common::move(node._key)) {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage may fill up before being increased
+		// automatically. Robin Hood hashing stays fast at high loads.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 4,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 5,
+
+		// Distances are stored in bytes. Longer ones, which only happen with
+		// a very bad hash function, are stored as this value and computed
+		// from the hash of the key when needed.
+		FLATHASHMAP_MAX_DISTANCE = 255
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_distances;	///< Distance + 1 of each node from its home slot up to FLATHASHMAP_MAX_DISTANCE, 0 for empty slots
+	Node *_nodes;		///< Uninitialized storage for the nodes
+	size_type _mask;	///< Capacity of the FlatHashMap minus one; capacity is a power of two
+	size_type _shift;	///< 32 - log2(capacity), to take the top bits of the hash
+	size_type _size;
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static const size_type NONE_FOUND = (size_type)-1;
+
+	/**
+	 * The home slot of @p key. The hash functions for integers return the
+	 * value, so the hash is mixed with a multiplication (Fibonacci hashing)
+	 * to spread sequences and multiples over the table.
+	 */
+	size_type homeSlot(const Key &key) const {
+		return (size_type)((uint32)_hash(key) * 2654435769U) >> _shift;
+	}
+
+	/** The distance + 1 of the node in @p slot from its home slot, or 0 if the slot is empty. */
+	uint distanceAt(size_type slot) const {
+		const uint distance = _distances[slot];
+		if (distance < FLATHASHMAP_MAX_DISTANCE)
+			return distance;
+		return ((slot - homeSlot(_nodes[slot]._key)) & _mask) + 1;
+	}
+
+	void setDistance(size_type slot, uint distance) {
+		_distances[slot] = (byte)MIN<uint>(distance, FLATHASHMAP_MAX_DISTANCE);
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	size_type insertNew(Node &&node);
+	void expandStorage(size_type newCapacity);
+	void eraseSlot(size_type slot);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(_hashmap->_distances[_idx] != 0);
+			return &_hashmap->_nodes[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextUsedSlot(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	size_type nextUsedSlot(size_type slot) const {
+		for (; slot <= _mask; ++slot) {
+			if (_distances[slot])
+				return slot;
+		}
+		return NONE_FOUND;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		clear();
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		return iterator(nextUsedSlot(0), this);
+	}
+	iterator	end() {
+		return iterator(NONE_FOUND, this);
+	}
+
+	const_iterator	begin() const {
+		return const_iterator(nextUsedSlot(0), this);
+	}
+	const_iterator	end() const {
+		return const_iterator(NONE_FOUND, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal(), _size(0) {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	clear();
+	freeStorage();
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	_mask = capacity - 1;
+	_shift = 32;
+	while (capacity > 1) {
+		capacity >>= 1;
+		_shift--;
+	}
+
+	_distances = new byte[_mask + 1];
+	memset(_distances, 0, _mask + 1);
+	_nodes = (Node *)malloc((_mask + 1) * sizeof(Node));
+	assert(_nodes != nullptr);
+}
+
+/**
+ * Free the storage, which must be empty.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	delete[] _distances;
+	free(_nodes);
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// With the same capacity, every node can go to the same slot
+	memcpy(_distances, map._distances, _mask + 1);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (_distances[ctr]) {
+			new ((void *)&_nodes[ctr]) Node(map._nodes[ctr]._key);
+			_nodes[ctr]._value = map._nodes[ctr]._value;
+		}
+	}
+	_size = map._size;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (_distances[ctr])
+			_nodes[ctr].~Node();
+	}
+	memset(_distances, 0, _mask + 1);
+	_size = 0;
+
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(size_type newCapacity) {
+	assert(newCapacity > _mask + 1);
+
+	const size_type oldMask = _mask;
+	byte *oldDistances = _distances;
+	Node *oldNodes = _nodes;
+
+#ifndef NDEBUG
+	const size_type oldSize = _size;
+#endif
+
+	allocStorage(newCapacity);
+	_size = 0;
+
+	// Reinsert all the old elements. No key exists twice in the old table,
+	// so the new ones don't have to be compared with the others.
+	for (size_type ctr = 0; ctr <= oldMask; ++ctr) {
+		if (oldDistances[ctr]) {
+			insertNew(Common::move(oldNodes[ctr]));
+			oldNodes[ctr].~Node();
+		}
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	assert(_size == oldSize);
+
+	delete[] oldDistances;
+	free(oldNodes);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	size_type ctr = homeSlot(key);
+
+	// Nodes are ordered by distance, so once the distance of the node in a
+	// slot is lower than the distance from the home slot, key can't follow
+	for (uint distance = 1;; ++distance) {
+		const uint slotDistance = distanceAt(ctr);
+		if (slotDistance < distance)
+			return NONE_FOUND;
+		if (slotDistance == distance && _equal(_nodes[ctr]._key, key))
+			return ctr;
+
+		ctr = (ctr + 1) & _mask;
+	}
+}
+
+/**
+ * Insert @p node, whose key must not be in the map yet, and return its slot.
+ * There must be room for it.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::insertNew(Node &&node) {
+	size_type ctr = homeSlot(node._key);
+	size_type result = NONE_FOUND;
+
+	// The node which is looking for a slot; initially the new one, and
+	// then those it displaces
+	Node carried(Common::move(node));
+	uint distance = 1;
+
+	for (;;) {
+		if (!_distances[ctr]) {
+			new ((void *)&_nodes[ctr]) Node(Common::move(carried));
+			setDistance(ctr, distance);
+			if (result == NONE_FOUND)
+				result = ctr;
+			break;
+		}
+
+		const uint slotDistance = distanceAt(ctr);
+		if (slotDistance < distance) {
+			// Take the slot of a node which is closer to its home, and carry
+			// that one on
+			Node displaced(Common::move(_nodes[ctr]));
+			_nodes[ctr].~Node();
+			new ((void *)&_nodes[ctr]) Node(Common::move(carried));
+			carried.~Node();
+			new ((void *)&carried) Node(Common::move(displaced));
+
+			setDistance(ctr, distance);
+			distance = slotDistance;
+			if (result == NONE_FOUND)
+				result = ctr;
+		}
+
+		ctr = (ctr + 1) & _mask;
+		distance++;
+	}
+
+	_size++;
+	return result;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return ctr;
+
+	// Keep the load factor below a certain threshold
+	size_type capacity = _mask + 1;
+	if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+		expandStorage(capacity);
+	}
+
+	return insertNew(Node(key));
+}
+
+/**
+ * Remove the node in @p slot and move the nodes following it closer to
+ * their home slots.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type slot) {
+	assert(slot <= _mask && _distances[slot]);
+
+	_nodes[slot].~Node();
+	for (;;) {
+		const size_type next = (slot + 1) & _mask;
+		if (_distances[next] <= 1) {
+			_distances[slot] = 0;
+			break;
+		}
+
+		setDistance(slot, distanceAt(next) - 1);
+		new ((void *)&_nodes[slot]) Node(Common::move(_nodes[next]));
+		_nodes[next].~Node();
+		slot = next;
+	}
+
+	_size--;
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != NONE_FOUND;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// This can reallocate the storage, so don't use _nodes before
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	return _nodes[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _nodes[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _nodes[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _nodes[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND) {
+		out = _nodes[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	_nodes[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	eraseSlot(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
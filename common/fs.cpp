@@ -390,6 +390,11 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const Path &path) con
 	return stream;
 }
 
+AsyncReadHandle FSDirectory::openAsync(const Path &path) const {
+	// Every file has its own stream, so they can be read in the background
+	return AsyncReadHandle(createReadStreamForMember(path), true);
+}
+
 SeekableReadStream *FSDirectory::createReadStreamForMemberAltStream(const Path &path, AltStreamType altStreamType) const {
 	if (path.empty() || !_node.isDirectory())
 		return nullptr;
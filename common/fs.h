@@ -443,6 +443,12 @@ public:
 	 * for success.
 	 */
 	SeekableReadStream *createReadStreamForMemberAltStream(const Path &path, AltStreamType altStreamType) const override;
+
+	/**
+	 * Open the specified file and read it in the background. A full match of relative
+	 * path and file name is needed for success.
+	 */
+	AsyncReadHandle openAsync(const Path &path) const override;
 };
 
 /** @} */
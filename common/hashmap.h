@@ -32,9 +32,9 @@
 //#define DEBUG_HASH_COLLISIONS
 
 /**
- * Enable the following define to let HashMaps use a memory pool for the
- * nodes they contain. This increases memory usage, but can also improve
- * speed quite a bit.
+ * Enable the following define to let HashMaps allocate the nodes they
+ * contain with the shared small object allocator (see common/smallalloc.h)
+ * instead of new. This can improve speed quite a bit.
  */
 #define USE_HASHMAP_MEMORY_POOL
 
@@ -48,9 +48,12 @@
 #endif
 
 #ifdef USE_HASHMAP_MEMORY_POOL
-#include "common/memorypool.h"
+#include "common/smallalloc.h"
 #endif
 
+// Used to come in through memorypool.h, and many users rely on it
+#include "common/array.h"
+
 namespace Common {
 
 /**
@@ -107,15 +110,9 @@ private:
 		// Note: the quotient of these two must be between and different
 		// from 0 and 1.
 		HASHMAP_LOADFACTOR_NUMERATOR = 2,
-		HASHMAP_LOADFACTOR_DENOMINATOR = 3,
-
-		HASHMAP_MEMORYPOOL_SIZE = HASHMAP_MIN_CAPACITY * HASHMAP_LOADFACTOR_NUMERATOR / HASHMAP_LOADFACTOR_DENOMINATOR
+		HASHMAP_LOADFACTOR_DENOMINATOR = 3
 	};
 
-#ifdef USE_HASHMAP_MEMORY_POOL
-	ObjectPool<Node, HASHMAP_MEMORYPOOL_SIZE> _nodePool;
-#endif
-
 	/** Default value, returned by the const getVal. */
 	Val _defaultVal;
 
@@ -136,18 +133,20 @@ private:
 
 	Node *allocNode(const Key &key) {
 #ifdef USE_HASHMAP_MEMORY_POOL
-		return new (_nodePool) Node(key);
+		return new (allocSmall(sizeof(Node))) Node(key);
 #else
 		return new Node(key);
 #endif
 	}
 
 	void freeNode(Node *node) {
-		if (node && node != HASHMAP_DUMMY_NODE)
+		if (!node || node == HASHMAP_DUMMY_NODE)
+			return;
 #ifdef USE_HASHMAP_MEMORY_POOL
-			_nodePool.deleteChunk(node);
+		node->~Node();
+		freeSmall(node, sizeof(Node));
 #else
-			delete node;
+		delete node;
 #endif
 	}
 
@@ -430,10 +429,6 @@ void HashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
 		_storage[ctr] = nullptr;
 	}
 
-#ifdef USE_HASHMAP_MEMORY_POOL
-	_nodePool.freeUnusedPages();
-#endif
-
 	if (shrinkArray && _mask >= HASHMAP_MIN_CAPACITY) {
 		delete[] _storage;
 
@@ -22,6 +22,7 @@
 #ifndef COMMON_LIST_H
 #define COMMON_LIST_H
 
+#include "common/smallalloc.h"
 #include "common/list_intern.h"
 
 namespace Common {
@@ -207,7 +208,7 @@ public:
 		while (pos != &_anchor) {
 			Node *node = static_cast<Node *>(pos);
 			pos = pos->_next;
-			delete node;
+			freeNode(node);
 		}
 
 		_anchor._prev = &_anchor;
@@ -262,6 +263,11 @@ public:
 	}
 
 protected:
+	void freeNode(Node *node) {
+		node->~Node();
+		freeSmall(node, sizeof(Node));
+	}
+
 	/**
 	 * Erase an element at @p pos.
 	 */
@@ -270,7 +276,7 @@ protected:
 		Node *node = static_cast<Node *>(pos);
 		n._prev->_next = n._next;
 		n._next->_prev = n._prev;
-		delete node;
+		freeNode(node);
 		return n;
 	}
 
@@ -278,8 +284,7 @@ protected:
 	 * Insert an @p element before @p pos.
 	 */
 	void insert(NodeBase *pos, const t_T &element) {
-		ListInternal::NodeBase *newNode = new Node(element);
-		assert(newNode);
+		ListInternal::NodeBase *newNode = new (allocSmall(sizeof(Node))) Node(element);
 
 		newNode->_next = pos;
 		newNode->_prev = pos->_prev;
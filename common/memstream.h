@@ -93,6 +93,8 @@ public:
 	int64 size() const { return _size; }
 
 	bool seek(int64 offs, int whence = SEEK_SET);
+
+	const byte *borrow(uint32 len);
 };
 
 
@@ -111,6 +113,8 @@ public:
 	bool seek(int64 offs, int whence = SEEK_SET) override { return MemoryReadStream::seek(offs, whence); }
 
 	bool skip(uint32 offset) override { return MemoryReadStream::seek(offset, SEEK_CUR); }
+
+	const byte *borrow(uint32 len) override { return MemoryReadStream::borrow(len); }
 };
 
 /**
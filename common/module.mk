@@ -25,10 +25,12 @@ MODULE_OBJS := \
 	osd_message_queue.o \
 	path.o \
 	platform.o \
+	prefetch.o \
 	punycode.o \
 	random.o \
 	rational.o \
 	rendermode.o \
+	smallalloc.o \
 	str.o \
 	stream.o \
 	streamdebug.o \
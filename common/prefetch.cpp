@@ -0,0 +1,568 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/prefetch.h"
+
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+namespace {
+
+enum {
+	// Most bytes one job reads at a time
+	kIOChunkSize = 16 * 1024,
+
+	// Most bytes of whole files held in memory by the background reads at
+	// once. Files which don't fit are opened as they are instead.
+	kMaxBufferedBytes = 16 * 1024 * 1024,
+
+	// Touching one byte per page is enough to page in mapped files
+	kPageSize = 4096
+};
+
+/**
+ * Something which reads ahead in idle time. Jobs may be added and removed on
+ * any thread.
+ */
+class IOJob {
+public:
+	IOJob() : _registered(false) {}
+	virtual ~IOJob() {}
+
+	/**
+	 * Read at most @p maxBytes ahead.
+	 *
+	 * @return The number of bytes read, 0 if there is nothing left to do.
+	 */
+	virtual uint32 process(uint32 maxBytes) = 0;
+
+	bool _registered;
+};
+
+/**
+ * Keeps the list of jobs, which readAhead() runs, and tracks the memory used
+ * by them.
+ *
+ * It is created by the first call to addJob() or reserve(), which has to
+ * happen on the main thread, and lives until the end of the program. The
+ * other calls can be made from any thread, e.g. the audio thread, which
+ * destroys the prefetching streams of music.
+ */
+class IOWorker {
+public:
+	static void addJob(IOJob *job);
+	static void removeJob(IOJob *job);
+
+	/**
+	 * Reserve @p bytes of the kMaxBufferedBytes budget.
+	 *
+	 * @return false if the budget does not allow for it
+	 */
+	static bool reserve(uint32 bytes);
+
+	/** Return @p bytes reserved by reserve() to the budget. */
+	static void release(uint32 bytes);
+
+	/** Run the jobs for at most @p maxBytes, see readAhead(). */
+	static bool run(uint32 maxBytes);
+
+private:
+	IOWorker();
+
+	static IOWorker *instance();
+
+	Mutex _mutex;
+	Array<IOJob *> _jobs;
+	uint _nextJob;
+	uint32 _bufferedBytes;
+
+	static IOWorker *_worker;
+};
+
+IOWorker *IOWorker::_worker = nullptr;
+
+IOWorker::IOWorker() : _nextJob(0), _bufferedBytes(0) {
+}
+
+IOWorker *IOWorker::instance() {
+	if (!_worker)
+		_worker = new IOWorker();
+	return _worker;
+}
+
+void IOWorker::addJob(IOJob *job) {
+	IOWorker *worker = instance();
+
+	StackLock lock(worker->_mutex);
+	worker->_jobs.push_back(job);
+	job->_registered = true;
+}
+
+void IOWorker::removeJob(IOJob *job) {
+	if (!job->_registered)
+		return;
+
+	// Jobs are processed with the mutex held, so once we have it, this one
+	// isn't in use. This waits for at most one chunk to be read.
+	StackLock lock(_worker->_mutex);
+	for (uint i = 0; i < _worker->_jobs.size(); ++i) {
+		if (_worker->_jobs[i] == job) {
+			_worker->_jobs.remove_at(i);
+			break;
+		}
+	}
+	job->_registered = false;
+}
+
+bool IOWorker::reserve(uint32 bytes) {
+	IOWorker *worker = instance();
+
+	StackLock lock(worker->_mutex);
+	if (bytes > kMaxBufferedBytes - worker->_bufferedBytes)
+		return false;
+
+	worker->_bufferedBytes += bytes;
+	return true;
+}
+
+void IOWorker::release(uint32 bytes) {
+	StackLock lock(_worker->_mutex);
+	assert(bytes <= _worker->_bufferedBytes);
+	_worker->_bufferedBytes -= bytes;
+}
+
+bool IOWorker::run(uint32 maxBytes) {
+	if (!_worker)
+		return false;
+
+	uint32 budget = maxBytes;
+	uint idle = 0;
+	bool done = false;
+
+	// Go round robin over the jobs, one chunk at a time, until all of them
+	// are done or the budget is used up. The mutex is released after each
+	// chunk, so that jobs can be removed in between.
+	while (budget) {
+		StackLock lock(_worker->_mutex);
+		if (idle >= _worker->_jobs.size())
+			break;
+
+		if (_worker->_nextJob >= _worker->_jobs.size())
+			_worker->_nextJob = 0;
+
+		const uint32 read = _worker->_jobs[_worker->_nextJob++]->process(MIN<uint32>(budget, kIOChunkSize));
+		if (read) {
+			budget -= MIN(budget, read);
+			idle = 0;
+			done = true;
+		} else {
+			++idle;
+		}
+	}
+
+	return done;
+}
+
+} // End of anonymous namespace
+
+/**
+ * Reads a whole stream into memory. Streams which can lend their data
+ * already have it in memory, or in a memory mapped file; for those only the
+ * pages are touched, so that they are loaded before the data is used.
+ * Other streams are only read into memory if that stays within
+ * kMaxBufferedBytes, and passed on as they are otherwise.
+ */
+class AsyncReadRequest : public IOJob {
+public:
+	AsyncReadRequest(SeekableReadStream *stream, bool readInBackground);
+	~AsyncReadRequest() override;
+
+	bool isReady();
+	SeekableReadStream *getStream();
+
+	uint32 process(uint32 maxBytes) override;
+
+private:
+	uint32 processLocked(uint32 maxBytes);
+
+	Mutex _mutex;
+	SeekableReadStream *_stream;
+	const byte *_borrowed;
+	byte *_data;
+	uint32 _size;
+	uint32 _done;
+	bool _failed;
+};
+
+AsyncReadRequest::AsyncReadRequest(SeekableReadStream *stream, bool readInBackground) :
+		_stream(stream), _borrowed(nullptr), _data(nullptr), _size(0), _done(0), _failed(false) {
+	const int64 size = stream->size();
+	if (!readInBackground || size <= 0 || size > 0x7FFFFFFF || !stream->seek(0))
+		return;
+
+	_borrowed = stream->borrow(size);
+	if (_borrowed) {
+		stream->seek(0);
+	} else {
+		if (!IOWorker::reserve(size))
+			return;
+
+		_data = (byte *)malloc(size);
+		if (!_data) {
+			IOWorker::release(size);
+			return;
+		}
+	}
+
+	_size = size;
+
+	IOWorker::addJob(this);
+}
+
+AsyncReadRequest::~AsyncReadRequest() {
+	IOWorker::removeJob(this);
+	delete _stream;
+
+	if (_data) {
+		free(_data);
+		IOWorker::release(_size);
+	}
+}
+
+bool AsyncReadRequest::isReady() {
+	StackLock lock(_mutex);
+	return _done == _size;
+}
+
+SeekableReadStream *AsyncReadRequest::getStream() {
+	if (!_stream)
+		return nullptr;
+
+	IOWorker::removeJob(this);
+	while (processLocked(_size - _done))
+		;
+
+	SeekableReadStream *stream = _stream;
+	_stream = nullptr;
+
+	if (_data) {
+		// The data is the caller's from now on
+		IOWorker::release(_size);
+	}
+
+	if (_failed) {
+		delete stream;
+		free(_data);
+		_data = nullptr;
+		return nullptr;
+	}
+
+	if (_data) {
+		delete stream;
+		stream = new MemoryReadStream(_data, _size, DisposeAfterUse::YES);
+		_data = nullptr;
+	}
+
+	return stream;
+}
+
+uint32 AsyncReadRequest::process(uint32 maxBytes) {
+	StackLock lock(_mutex);
+	return processLocked(maxBytes);
+}
+
+uint32 AsyncReadRequest::processLocked(uint32 maxBytes) {
+	const uint32 len = MIN(maxBytes, _size - _done);
+	if (!len)
+		return 0;
+
+	if (_borrowed) {
+		volatile byte sink = 0;
+		for (uint32 i = 0; i < len; i += kPageSize)
+			sink += _borrowed[_done + i];
+		(void)sink;
+	} else if (_stream->read(_data + _done, len) != len) {
+		warning("AsyncReadRequest: Could not read the stream");
+		_failed = true;
+		_done = _size;
+		return len;
+	}
+
+	_done += len;
+	return len;
+}
+
+AsyncReadHandle::AsyncReadHandle(SeekableReadStream *stream, bool readInBackground) {
+	if (stream)
+		_request.reset(new AsyncReadRequest(stream, readInBackground));
+}
+
+bool AsyncReadHandle::isReady() const {
+	return !_request || _request->isReady();
+}
+
+SeekableReadStream *AsyncReadHandle::getStream() {
+	return _request ? _request->getStream() : nullptr;
+}
+
+namespace {
+
+/**
+ * Keeps a ring buffer filled with the data following the current position.
+ * readAhead() and read() both fill it, the latter when readAhead() did not
+ * keep up.
+ *
+ * _mutex protects the buffer state and is only held for copies, while
+ * _ioMutex is held while the parent stream is used. Reads which find their
+ * data buffered thus never wait for the parent stream, even if readAhead()
+ * is reading from it on another thread at the time. _ioMutex is always
+ * taken first.
+ */
+class PrefetchingSeekableReadStream : public SeekableReadStream, public IOJob {
+public:
+	PrefetchingSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
+	~PrefetchingSeekableReadStream() override;
+
+	bool err() const override;
+	void clearErr() override;
+	bool eos() const override { return _eos; }
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+
+	uint32 process(uint32 maxBytes) override;
+
+private:
+	uint32 fill(uint32 maxBytes);
+	uint32 readLocked(byte *dst, uint32 dataSize, bool fromParent);
+	bool skipBuffered(int64 offset);
+
+	DisposablePtr<SeekableReadStream> _parentStream;
+	mutable Mutex _ioMutex;
+	mutable Mutex _mutex;
+
+	byte *_buffer;
+	const uint32 _bufSize;
+	uint32 _head;	///< Offset of the data at _pos in the buffer
+	uint32 _filled;	///< Number of bytes buffered from _pos on
+
+	int64 _pos;
+	const int64 _size;
+	bool _eos;
+};
+
+PrefetchingSeekableReadStream::PrefetchingSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream) :
+		_parentStream(parentStream, disposeParentStream),
+		_bufSize(bufSize),
+		_head(0),
+		_filled(0),
+		_pos(parentStream->pos()),
+		_size(parentStream->size()),
+		_eos(false) {
+	assert(_bufSize > 0);
+	_buffer = new byte[_bufSize];
+
+	IOWorker::addJob(this);
+}
+
+PrefetchingSeekableReadStream::~PrefetchingSeekableReadStream() {
+	IOWorker::removeJob(this);
+	delete[] _buffer;
+}
+
+bool PrefetchingSeekableReadStream::err() const {
+	StackLock ioLock(_ioMutex);
+	return _parentStream->err();
+}
+
+void PrefetchingSeekableReadStream::clearErr() {
+	StackLock ioLock(_ioMutex);
+	StackLock lock(_mutex);
+	_eos = false;
+	_parentStream->clearErr();
+}
+
+uint32 PrefetchingSeekableReadStream::fill(uint32 maxBytes) {
+	// Both mutexes must be held. The parent stream is always positioned at
+	// the end of the buffered data.
+	if (_filled == _bufSize || _parentStream->eos() || _parentStream->err())
+		return 0;
+
+	const uint32 tail = (_head + _filled) % _bufSize;
+	const uint32 len = MIN(MIN(maxBytes, _bufSize - _filled), _bufSize - tail);
+	const uint32 done = _parentStream->read(_buffer + tail, len);
+	_filled += done;
+
+	return done;
+}
+
+uint32 PrefetchingSeekableReadStream::process(uint32 maxBytes) {
+	StackLock ioLock(_ioMutex);
+	if (_parentStream->eos() || _parentStream->err())
+		return 0;
+
+	// Reading only consumes data, and seeking beyond the buffered data
+	// needs _ioMutex, so the free space after the buffered data stays free
+	// while the parent stream is read without _mutex
+	uint32 tail, len;
+	{
+		StackLock lock(_mutex);
+		tail = (_head + _filled) % _bufSize;
+		len = MIN(MIN(maxBytes, _bufSize - _filled), _bufSize - tail);
+	}
+	if (!len)
+		return 0;
+
+	const uint32 done = _parentStream->read(_buffer + tail, len);
+
+	StackLock lock(_mutex);
+	_filled += done;
+	return done;
+}
+
+uint32 PrefetchingSeekableReadStream::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 done;
+	{
+		StackLock lock(_mutex);
+		done = readLocked(dst, dataSize, false);
+	}
+
+	if (done < dataSize) {
+		StackLock ioLock(_ioMutex);
+		StackLock lock(_mutex);
+		done += readLocked(dst + done, dataSize - done, true);
+	}
+
+	return done;
+}
+
+uint32 PrefetchingSeekableReadStream::readLocked(byte *dst, uint32 dataSize, bool fromParent) {
+	// _mutex must be held, and _ioMutex as well if fromParent is set
+	uint32 left = dataSize;
+
+	while (left) {
+		if (!_filled) {
+			if (!fromParent)
+				break;
+
+			if (left >= _bufSize) {
+				// Big reads go straight to the destination
+				const uint32 done = _parentStream->read(dst, left);
+				_pos += done;
+				left -= done;
+				break;
+			}
+
+			if (!fill(kIOChunkSize))
+				break;
+		}
+
+		const uint32 len = MIN(MIN(left, _filled), _bufSize - _head);
+		memcpy(dst, _buffer + _head, len);
+		_head = (_head + len) % _bufSize;
+		_filled -= len;
+		_pos += len;
+		dst += len;
+		left -= len;
+	}
+
+	if (left && fromParent)
+		_eos = true;
+
+	return dataSize - left;
+}
+
+bool PrefetchingSeekableReadStream::skipBuffered(int64 offset) {
+	// _mutex must be held
+	if (offset < _pos || offset > _pos + _filled)
+		return false;
+
+	const uint32 skip = offset - _pos;
+	_head = (_head + skip) % _bufSize;
+	_filled -= skip;
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+bool PrefetchingSeekableReadStream::seek(int64 offset, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offset += _size;
+		break;
+	case SEEK_CUR:
+		offset += _pos;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offset < 0 || offset > _size)
+		return false;
+
+	// Skip forward within the buffered data, if possible without waiting
+	// for the parent stream
+	{
+		StackLock lock(_mutex);
+		if (skipBuffered(offset))
+			return true;
+	}
+
+	StackLock ioLock(_ioMutex);
+	StackLock lock(_mutex);
+	if (skipBuffered(offset))
+		return true;
+
+	_head = 0;
+	_filled = 0;
+	if (!_parentStream->seek(offset)) {
+		_parentStream->seek(_pos);
+		return false;
+	}
+
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+} // End of anonymous namespace
+
+SeekableReadStream *wrapPrefetchingSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream) {
+	if (!parentStream)
+		return nullptr;
+
+	return new PrefetchingSeekableReadStream(parentStream, bufSize, disposeParentStream);
+}
+
+bool readAhead(uint32 maxBytes) {
+	return IOWorker::run(maxBytes);
+}
+
+} // End of namespace Common
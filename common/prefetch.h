@@ -0,0 +1,130 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_PREFETCH_H
+#define COMMON_PREFETCH_H
+
+#include "common/ptr.h"
+#include "common/stream.h"
+#include "common/types.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_prefetch Background file reading
+ * @ingroup common_stream
+ *
+ * @brief API for reading files ahead of their use.
+ *
+ * The reading ahead is done by readAhead(), which engines call in their idle
+ * time, e.g. while waiting for the next frame, like
+ * Video::VideoDecoder::decodeAhead(). It is not done on the timer thread,
+ * as timer callbacks run with the TimerManager mutex held and a slow read
+ * would delay all other timers, including the MIDI players. Whatever was not
+ * read ahead yet is read on demand on the thread using the stream, so the
+ * result is always the same.
+ *
+ * Whole files are only read into memory as long as the total stays below a
+ * fixed limit; files beyond it are handed out as they were opened.
+ *
+ * Streams handed over for reading ahead must not be used by anything else
+ * while they are. Archives therefore only read members in the background if
+ * these are independent files, see Archive::openAsync().
+ *
+ * @{
+ */
+
+class AsyncReadRequest;
+
+/**
+ * Handle to an archive member which is being read in the background,
+ * returned by Archive::openAsync(). Copies of a handle refer to the same
+ * request; the reading is cancelled when the last one is destroyed.
+ */
+class AsyncReadHandle {
+public:
+	/** Create a handle for a member which was not found. */
+	AsyncReadHandle() {}
+
+	/**
+	 * Create a handle for @p stream, which it takes ownership of. If
+	 * @p readInBackground is false, the stream is passed on as it is.
+	 */
+	AsyncReadHandle(SeekableReadStream *stream, bool readInBackground);
+
+	/** Return false if the member was not found. */
+	bool isValid() const { return _request.get() != nullptr; }
+
+	/**
+	 * Return true if getStream() would return without any more I/O. This
+	 * does not block.
+	 */
+	bool isReady() const;
+
+	/**
+	 * Return the stream with the member data, finishing the reading on the
+	 * calling thread if necessary. The caller takes ownership of the stream;
+	 * later calls return nullptr. Also returns nullptr if the member was not
+	 * found or could not be read.
+	 */
+	SeekableReadStream *getStream();
+
+private:
+	SharedPtr<AsyncReadRequest> _request;
+};
+
+/**
+ * Take an arbitrary SeekableReadStream and wrap it in a custom stream that
+ * reads ahead of the current position, see readAhead(). This hides the
+ * latency of slow storage for streams which are read sequentially, like
+ * video and music files.
+ *
+ * The wrapped stream must not be accessed directly while the wrapper exists.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ *
+ * @param parentStream        The SeekableReadStream to wrap in a custom stream.
+ * @param bufSize             How far to read ahead, in bytes.
+ * @param disposeParentStream Flag indicating whether to dispose of the wrapped stream.
+ */
+SeekableReadStream *wrapPrefetchingSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
+
+/**
+ * Do pending reading ahead for the streams returned by
+ * wrapPrefetchingSeekableReadStream() and the handles returned by
+ * Archive::openAsync(), on the calling thread.
+ *
+ * This is meant to be called repeatedly in the idle time of an engine. It
+ * reads in chunks of limited size, so it returns shortly after
+ * @p maxBytes were read.
+ *
+ * @param maxBytes How many bytes to read at most.
+ *
+ * @return false if there was nothing left to read.
+ */
+bool readAhead(uint32 maxBytes = 64 * 1024);
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
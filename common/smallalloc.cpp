@@ -0,0 +1,474 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/smallalloc.h"
+#include "common/system.h"
+
+namespace Common {
+
+namespace {
+
+// Steps of 16 bytes, so that all blocks of 16 bytes and more are aligned
+// for any type, like those of malloc(). Smaller blocks can't hold a type
+// with a bigger alignment than 8.
+const uint16 kClassSizes[kNumSmallAllocClasses] = {
+	8, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 256
+};
+
+STATIC_ASSERT(alignof(max_align_t) <= 16, size_classes_are_not_aligned_for_max_align_t);
+
+// Size class for each size rounded up to a multiple of 8, divided by 8
+const byte kSizeToClass[kMaxSmallAllocSize / 8 + 1] = {
+	0, 0, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8,
+	9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15, 15, 15
+};
+
+inline uint sizeToClass(size_t size) {
+	return kSizeToClass[(size + 7) >> 3];
+}
+
+} // End of anonymous namespace
+
+#ifdef SCUMMVM_SMALL_ALLOC
+
+namespace {
+
+enum {
+	/** Number of blocks moved between a thread cache and the shared lists at once */
+	kBatchSize = 32,
+	/** A thread cache returns a batch when it holds more free blocks than this */
+	kMaxCachedBlocks = 2 * kBatchSize,
+	/** Completely free pages kept per size class, instead of freeing them */
+	kMaxEmptyPages = 1
+};
+
+// All of the shared state is zero initialized, so the allocator works during
+// static initialization, before any constructor ran.
+
+inline void cpuRelax() {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	__builtin_ia32_pause();
+#elif defined(__GNUC__) && (defined(__aarch64__) || (defined(__arm__) && __ARM_ARCH >= 7))
+	__asm__ __volatile__("yield");
+#endif
+}
+
+void lockSpin(int *lock) {
+	// The locks are only taken to move whole batches, so they are hardly
+	// ever contended. If the holder was preempted though, spinning on
+	// would only waste its time slice, so back off and give up the CPU.
+	uint spins = 1;
+	while (atomicExchange(lock, 1)) {
+		while (atomicLoadAcquire(lock)) {
+			if (spins <= 64) {
+				for (uint i = 0; i < spins; ++i)
+					cpuRelax();
+				spins *= 2;
+			} else if (g_system) {
+				g_system->delayMillis(0);
+			}
+		}
+	}
+}
+
+void unlockSpin(int *lock) {
+	atomicStoreRelease(lock, 0);
+}
+
+/** The header at the start of every page. The blocks follow it. */
+struct Page {
+	Page *prev; ///< In the list of pages with free blocks
+	Page *next;
+	void *freeList;
+	uint32 freeCount;
+};
+
+// Keeps the blocks after the header aligned like those of malloc()
+const uint kPageHeaderSize = (sizeof(Page) + 15) & ~15;
+
+inline uint blocksPerPage(uint cls) {
+	return (kSmallAllocPageSize - kPageHeaderSize) / kClassSizes[cls];
+}
+
+struct SharedClass {
+	int lock;
+	Page *partial;      ///< Pages with free blocks
+	Page **pages;       ///< All pages, sorted by address, to find the page of a block
+	uint32 numPages;
+	uint32 maxPages;
+	uint32 emptyPages;  ///< Pages whose blocks are all free
+};
+
+SharedClass g_classes[kNumSmallAllocClasses];
+
+struct SharedStats {
+	int lock;
+	uint64 allocations[kNumSmallAllocClasses];
+	uint64 cacheHits[kNumSmallAllocClasses];
+	int64 live[kNumSmallAllocClasses];
+	uint64 largeAllocations;
+	int64 bytesLive;
+	uint64 bytesPeak;
+	int64 bytesReserved;
+};
+
+SharedStats g_stats;
+
+/**
+ * The per thread state. The statistics are counted here without any locking
+ * and added to the shared ones whenever the thread has to lock anyway.
+ */
+struct ThreadCache {
+	void *freeList[kNumSmallAllocClasses];
+	uint32 count[kNumSmallAllocClasses];
+
+	uint32 allocations[kNumSmallAllocClasses];
+	uint32 cacheHits[kNumSmallAllocClasses];
+	int32 live[kNumSmallAllocClasses];
+	uint32 largeAllocations;
+	int64 largeBytes;
+	int64 pageBytes;
+
+	bool registered; ///< The ThreadCacheReaper is constructed
+	bool dead;       ///< The thread is exiting, don't cache anymore
+};
+
+// Plain old data, so accessing it does not need any initialization guard
+thread_local ThreadCache t_cache;
+
+void publishStats(ThreadCache &tc) {
+	lockSpin(&g_stats.lock);
+
+	int64 bytes = tc.largeBytes;
+	for (uint i = 0; i < kNumSmallAllocClasses; ++i) {
+		g_stats.allocations[i] += tc.allocations[i];
+		g_stats.cacheHits[i] += tc.cacheHits[i];
+		g_stats.live[i] += tc.live[i];
+		bytes += (int64)tc.live[i] * kClassSizes[i];
+
+		tc.allocations[i] = 0;
+		tc.cacheHits[i] = 0;
+		tc.live[i] = 0;
+	}
+	g_stats.largeAllocations += tc.largeAllocations;
+	g_stats.bytesLive += bytes;
+	if (g_stats.bytesLive > (int64)g_stats.bytesPeak)
+		g_stats.bytesPeak = g_stats.bytesLive;
+	g_stats.bytesReserved += tc.pageBytes;
+
+	tc.largeAllocations = 0;
+	tc.largeBytes = 0;
+	tc.pageBytes = 0;
+
+	unlockSpin(&g_stats.lock);
+}
+
+void unlinkPage(SharedClass &shared, Page *page) {
+	if (page->prev)
+		page->prev->next = page->next;
+	else
+		shared.partial = page->next;
+	if (page->next)
+		page->next->prev = page->prev;
+}
+
+void linkPage(SharedClass &shared, Page *page) {
+	page->prev = nullptr;
+	page->next = shared.partial;
+	if (shared.partial)
+		shared.partial->prev = page;
+	shared.partial = page;
+}
+
+/** Index of the first page in shared.pages at or after @p ptr. */
+uint lowerBound(const SharedClass &shared, const void *ptr) {
+	uint first = 0, last = shared.numPages;
+	while (first < last) {
+		const uint mid = (first + last) / 2;
+		if ((const void *)shared.pages[mid] < ptr)
+			first = mid + 1;
+		else
+			last = mid;
+	}
+	return first;
+}
+
+Page *findPage(const SharedClass &shared, const void *block) {
+	// The page starts before the block, so it is the one before the bound
+	const uint index = lowerBound(shared, block);
+	assert(index > 0);
+	Page *page = shared.pages[index - 1];
+	assert((const byte *)block < (const byte *)page + kSmallAllocPageSize);
+	return page;
+}
+
+void newPage(ThreadCache &tc, SharedClass &shared, uint cls) {
+	if (shared.numPages == shared.maxPages) {
+		shared.maxPages = shared.maxPages ? shared.maxPages * 2 : 16;
+		shared.pages = (Page **)::realloc(shared.pages, shared.maxPages * sizeof(Page *));
+		assert(shared.pages);
+	}
+
+	Page *page = (Page *)::malloc(kSmallAllocPageSize);
+	assert(page);
+
+	const uint size = kClassSizes[cls];
+	const uint count = blocksPerPage(cls);
+	byte *block = (byte *)page + kPageHeaderSize + (count - 1) * size;
+	page->freeList = nullptr;
+	for (uint i = 0; i < count; ++i, block -= size) {
+		*(void **)block = page->freeList;
+		page->freeList = block;
+	}
+	page->freeCount = count;
+
+	const uint index = lowerBound(shared, page);
+	memmove(shared.pages + index + 1, shared.pages + index, (shared.numPages - index) * sizeof(Page *));
+	shared.pages[index] = page;
+	++shared.numPages;
+
+	linkPage(shared, page);
+	++shared.emptyPages;
+	tc.pageBytes += kSmallAllocPageSize;
+}
+
+void releasePage(ThreadCache &tc, SharedClass &shared, Page *page) {
+	unlinkPage(shared, page);
+
+	const uint index = lowerBound(shared, page);
+	assert(index < shared.numPages && shared.pages[index] == page);
+	memmove(shared.pages + index, shared.pages + index + 1, (shared.numPages - index - 1) * sizeof(Page *));
+	--shared.numPages;
+
+	--shared.emptyPages;
+	tc.pageBytes -= kSmallAllocPageSize;
+	::free(page);
+}
+
+/**
+ * Move up to @p count blocks from the pages of @p cls to the thread cache,
+ * allocating a new page if none has free blocks. Returns the number of
+ * blocks moved.
+ */
+uint takeBlocks(ThreadCache &tc, uint cls, uint count) {
+	SharedClass &shared = g_classes[cls];
+	const uint perPage = blocksPerPage(cls);
+	uint taken = 0;
+
+	lockSpin(&shared.lock);
+
+	if (!shared.partial)
+		newPage(tc, shared, cls);
+
+	while (taken < count && shared.partial) {
+		Page *page = shared.partial;
+		if (page->freeCount == perPage)
+			--shared.emptyPages;
+
+		while (taken < count && page->freeList) {
+			void *block = page->freeList;
+			page->freeList = *(void **)block;
+			--page->freeCount;
+			*(void **)block = tc.freeList[cls];
+			tc.freeList[cls] = block;
+			++taken;
+		}
+
+		if (!page->freeCount)
+			unlinkPage(shared, page);
+	}
+
+	unlockSpin(&shared.lock);
+
+	tc.count[cls] += taken;
+	return taken;
+}
+
+/**
+ * Move @p count blocks from the thread cache back to their pages, and
+ * release the pages which become free.
+ */
+void returnBlocks(ThreadCache &tc, uint cls, uint count) {
+	assert(count > 0 && count <= tc.count[cls]);
+
+	SharedClass &shared = g_classes[cls];
+	const uint perPage = blocksPerPage(cls);
+
+	lockSpin(&shared.lock);
+
+	for (uint i = 0; i < count; ++i) {
+		void *block = tc.freeList[cls];
+		tc.freeList[cls] = *(void **)block;
+
+		Page *page = findPage(shared, block);
+		if (!page->freeCount)
+			linkPage(shared, page);
+		*(void **)block = page->freeList;
+		page->freeList = block;
+
+		if (++page->freeCount == perPage) {
+			++shared.emptyPages;
+			if (shared.emptyPages > kMaxEmptyPages)
+				releasePage(tc, shared, page);
+		}
+	}
+
+	unlockSpin(&shared.lock);
+
+	tc.count[cls] -= count;
+}
+
+/** Returns the cached blocks of a thread when it exits. */
+struct ThreadCacheReaper {
+	void touch() {}
+
+	~ThreadCacheReaper() {
+		ThreadCache &tc = t_cache;
+		for (uint i = 0; i < kNumSmallAllocClasses; ++i) {
+			if (tc.count[i])
+				returnBlocks(tc, i, tc.count[i]);
+		}
+		publishStats(tc);
+
+		// Static destructors may still free strings after this
+		tc.dead = true;
+	}
+};
+
+void registerThread(ThreadCache &tc) {
+	tc.registered = true;
+	static thread_local ThreadCacheReaper reaper;
+	reaper.touch();
+}
+
+void *allocSmallSlow(ThreadCache &tc, uint cls) {
+	if (!tc.registered)
+		registerThread(tc);
+
+	publishStats(tc);
+
+	takeBlocks(tc, cls, tc.dead ? 1 : (uint)kBatchSize);
+
+	void *ptr = tc.freeList[cls];
+	tc.freeList[cls] = *(void **)ptr;
+	--tc.count[cls];
+	++tc.allocations[cls];
+	++tc.live[cls];
+	return ptr;
+}
+
+} // End of anonymous namespace
+
+void *allocSmall(size_t size) {
+	ThreadCache &tc = t_cache;
+
+	if (size > kMaxSmallAllocSize) {
+		void *ptr = ::malloc(size);
+		assert(ptr);
+		++tc.largeAllocations;
+		tc.largeBytes += size;
+		return ptr;
+	}
+
+	const uint cls = sizeToClass(size);
+	void *ptr = tc.freeList[cls];
+	if (!ptr)
+		return allocSmallSlow(tc, cls);
+
+	tc.freeList[cls] = *(void **)ptr;
+	--tc.count[cls];
+	++tc.allocations[cls];
+	++tc.cacheHits[cls];
+	++tc.live[cls];
+	return ptr;
+}
+
+void freeSmall(void *ptr, size_t size) {
+	if (!ptr)
+		return;
+
+	ThreadCache &tc = t_cache;
+
+	if (size > kMaxSmallAllocSize) {
+		::free(ptr);
+		tc.largeBytes -= size;
+		return;
+	}
+
+	// Threads which only free blocks need to return them on exit as well
+	if (!tc.registered)
+		registerThread(tc);
+
+	const uint cls = sizeToClass(size);
+	*(void **)ptr = tc.freeList[cls];
+	tc.freeList[cls] = ptr;
+	++tc.count[cls];
+	--tc.live[cls];
+
+	if (tc.count[cls] > kMaxCachedBlocks || tc.dead) {
+		returnBlocks(tc, cls, tc.dead ? tc.count[cls] : (uint)kBatchSize);
+		publishStats(tc);
+	}
+}
+
+void getSmallAllocStats(SmallAllocStats &stats) {
+	publishStats(t_cache);
+
+	lockSpin(&g_stats.lock);
+	for (uint i = 0; i < kNumSmallAllocClasses; ++i) {
+		stats.sizeClasses[i].size = kClassSizes[i];
+		stats.sizeClasses[i].allocations = g_stats.allocations[i];
+		stats.sizeClasses[i].cacheHits = g_stats.cacheHits[i];
+		stats.sizeClasses[i].live = g_stats.live[i] > 0 ? g_stats.live[i] : 0;
+	}
+	stats.largeAllocations = g_stats.largeAllocations;
+	stats.bytesLive = g_stats.bytesLive > 0 ? g_stats.bytesLive : 0;
+	stats.bytesPeak = g_stats.bytesPeak;
+	stats.bytesReserved = g_stats.bytesReserved > 0 ? g_stats.bytesReserved : 0;
+	unlockSpin(&g_stats.lock);
+}
+
+#else
+
+// The allocator is disabled, or it can't work: without atomic operations
+// there is no way to lock before the backend is up, and without
+// thread_local the blocks cached by a thread can't be returned when it
+// exits. Everything goes to malloc, which is thread-safe.
+
+void *allocSmall(size_t size) {
+	void *ptr = ::malloc(size ? size : 1);
+	assert(ptr);
+	return ptr;
+}
+
+void freeSmall(void *ptr, size_t size) {
+	::free(ptr);
+}
+
+void getSmallAllocStats(SmallAllocStats &stats) {
+	memset(&stats, 0, sizeof(stats));
+	for (uint i = 0; i < kNumSmallAllocClasses; ++i)
+		stats.sizeClasses[i].size = kClassSizes[i];
+}
+
+#endif
+
+} // End of namespace Common
@@ -0,0 +1,121 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_SMALLALLOC_H
+#define COMMON_SMALLALLOC_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_smallalloc Small object allocator
+ * @ingroup common_memory
+ *
+ * @brief API for allocating many small memory blocks.
+ *
+ * allocSmall() hands out blocks of up to kMaxSmallAllocSize bytes from a
+ * fixed set of size classes. Each thread keeps a cache of free blocks per
+ * size class, so most allocations and frees neither lock nor call malloc;
+ * the caches are refilled from, and returned to, shared lists in batches.
+ * Unlike MemoryPool, a single allocator serves all users, and it may be used
+ * from any thread, including timer and audio callbacks.
+ *
+ * The blocks are carved from pages of kSmallAllocPageSize bytes. A page is
+ * returned to the system once all of its blocks are free again, except for
+ * one empty page per size class, which is kept to avoid allocating and
+ * freeing a page over and over. Blocks in the thread caches count as used.
+ *
+ * The allocator needs atomic operations, and thread_local variables with
+ * destructors to return the cached blocks of exiting threads. It is only
+ * built with USE_SMALL_ALLOC, which configure sets unless it is disabled
+ * with --disable-small-alloc or thread_local doesn't work. Otherwise
+ * SCUMMVM_SMALL_ALLOC is not defined and all blocks come from malloc().
+ *
+ * @{
+ */
+
+enum {
+	/** Largest size served from the size classes; bigger blocks use malloc. */
+	kMaxSmallAllocSize = 256,
+	/** Number of size classes. */
+	kNumSmallAllocClasses = 16,
+	/** Size of the pages the blocks are carved from. */
+	kSmallAllocPageSize = 16 * 1024
+};
+
+#if defined(SCUMMVM_ATOMICS) && defined(USE_SMALL_ALLOC)
+#define SCUMMVM_SMALL_ALLOC
+#endif
+
+#ifdef SCUMMVM_UTIL
+
+// The tools which share the string code don't link the allocator.
+inline void *allocSmall(size_t size) { return malloc(size); }
+inline void freeSmall(void *ptr, size_t size) { free(ptr); }
+
+#else
+
+/**
+ * Allocate a block of @p size bytes. Blocks of 16 bytes and more are
+ * aligned like those of malloc(), smaller ones to 8 bytes. Never returns
+ * nullptr.
+ */
+void *allocSmall(size_t size);
+
+/**
+ * Free a block obtained from allocSmall(). @p size must be the same size as
+ * passed to allocSmall(). The block may be freed on another thread than the
+ * one which allocated it.
+ */
+void freeSmall(void *ptr, size_t size);
+
+#endif
+
+/**
+ * Statistics of the small object allocator. Counters of other threads than
+ * the calling one are only published when these refill or flush their
+ * caches, so they may lag behind by a few dozen blocks per size class.
+ */
+struct SmallAllocStats {
+	struct SizeClass {
+		uint32 size;        ///< Block size of this class, in bytes
+		uint64 allocations; ///< Number of blocks allocated
+		uint64 cacheHits;   ///< Allocations served from a thread cache without locking
+		uint64 live;        ///< Number of blocks currently allocated
+	};
+
+	SizeClass sizeClasses[kNumSmallAllocClasses];
+	uint64 largeAllocations; ///< Number of blocks bigger than kMaxSmallAllocSize
+	uint64 bytesLive;        ///< Bytes currently allocated, by block size
+	uint64 bytesPeak;        ///< Maximum of bytesLive so far
+	uint64 bytesReserved;    ///< Bytes of the pages currently held for the size classes
+};
+
+/** Fill @p stats with the current allocator statistics. */
+void getSmallAllocStats(SmallAllocStats &stats);
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
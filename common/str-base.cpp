@@ -22,46 +22,15 @@
 #include "common/str-base.h"
 #include "common/hash-str.h"
 #include "common/list.h"
-#include "common/memorypool.h"
+#include "common/smallalloc.h"
 #include "common/textconsole.h"
 #include "common/util.h"
-#include "common/mutex.h"
 
 namespace Common {
 
 #define TEMPLATE template<class T>
 #define BASESTRING BaseString<T>
 
-MemoryPool *g_refCountPool = nullptr; // FIXME: This is never freed right now
-#ifndef SCUMMVM_UTIL
-Mutex *g_refCountPoolMutex = nullptr;
-
-void lockMemoryPoolMutex() {
-	// The Mutex class can only be used once g_system is set and initialized,
-	// but we may use the String class earlier than that (it is for example
-	// used in the OSystem_POSIX constructor). However in those early stages
-	// we can hope we don't have multiple threads either.
-	if (!g_system || !g_system->backendInitialized())
-		return;
-	if (!g_refCountPoolMutex)
-		g_refCountPoolMutex = new Mutex();
-	g_refCountPoolMutex->lock();
-}
-
-void unlockMemoryPoolMutex() {
-	if (g_refCountPoolMutex)
-		g_refCountPoolMutex->unlock();
-}
-
-TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
-	if (g_refCountPoolMutex){
-		delete g_refCountPoolMutex;
-		g_refCountPoolMutex = nullptr;
-	}
-}
-
-#endif
-
 static uint32 computeCapacity(uint32 len) {
 	// By default, for the capacity we use the next multiple of 32
 	return ((len + 32 - 1) & ~0x1F);
@@ -157,8 +126,7 @@ TEMPLATE void BASESTRING::ensureCapacity(uint32 new_size, bool keep_old) {
 			newCapacity = MAX(curCapacity * 2, computeCapacity(new_size + 1));
 
 		// Allocate new storage
-		newStorage = new value_type[newCapacity];
-		assert(newStorage);
+		newStorage = (value_type *)allocSmall(newCapacity * sizeof(value_type));
 	}
 
 	// Copy old data if needed, elsewise reset the new storage.
@@ -189,18 +157,7 @@ TEMPLATE
 void BASESTRING::incRefCount() const {
 	assert(!isStorageIntern());
 	if (_extern._refCount == nullptr) {
-#ifndef SCUMMVM_UTIL
-		lockMemoryPoolMutex();
-#endif
-		if (g_refCountPool == nullptr) {
-			g_refCountPool = new MemoryPool(sizeof(int));
-			assert(g_refCountPool);
-		}
-
-		_extern._refCount = (int *)g_refCountPool->allocChunk();
-#ifndef SCUMMVM_UTIL
-		unlockMemoryPoolMutex();
-#endif
+		_extern._refCount = (int *)allocSmall(sizeof(int));
 		*_extern._refCount = 2;
 	} else {
 		++(*_extern._refCount);
@@ -218,21 +175,15 @@ void BASESTRING::decRefCount(int *oldRefCount) {
 	if (!oldRefCount || *oldRefCount <= 0) {
 		// The ref count reached zero, so we free the string storage
 		// and the ref count storage.
-		if (oldRefCount) {
-#ifndef SCUMMVM_UTIL
-			lockMemoryPoolMutex();
-#endif
-			assert(g_refCountPool);
-			g_refCountPool->freeChunk(oldRefCount);
-#ifndef SCUMMVM_UTIL
-			unlockMemoryPoolMutex();
-#endif
-		}
+		if (oldRefCount)
+			freeSmall(oldRefCount, sizeof(int));
 		// Coverity thinks that we always free memory, as it assumes
 		// (correctly) that there are cases when oldRefCount == 0
 		// Thus, DO NOT COMPILE, trick it and shut tons of false positives
 #ifndef __COVERITY__
-		delete[] _str;
+		// ensureCapacity() may overwrite _extern with the internal storage,
+		// but only when the old storage is shared and thus not freed here.
+		freeSmall(_str, _extern._capacity * sizeof(value_type));
 #endif
 
 		// Even though _str points to a freed memory block now,
@@ -252,8 +203,7 @@ TEMPLATE void BASESTRING::initWithValueTypeStr(const value_type *str, uint32 len
 		// Not enough internal storage, so allocate more
 		_extern._capacity = computeCapacity(len + 1);
 		_extern._refCount = nullptr;
-		_str = new value_type[_extern._capacity];
-		assert(_str != nullptr);
+		_str = (value_type *)allocSmall(_extern._capacity * sizeof(value_type));
 	}
 
 	// Copy the string into the storage area
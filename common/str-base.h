@@ -31,8 +31,6 @@ namespace Common {
 template<class T>
 class BaseString {
 public:
-	static void releaseMemoryPoolMutex();
-
 	static const uint32 npos = 0xFFFFFFFF;
 	typedef T          value_type;
 	typedef T *        iterator;
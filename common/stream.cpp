@@ -124,6 +124,17 @@ uint32 MemoryReadStream::read(void *dataPtr, uint32 dataSize) {
 	return dataSize;
 }
 
+const byte *MemoryReadStream::borrow(uint32 len) {
+	if (len > _size - _pos)
+		return nullptr;
+
+	const byte *data = _ptr;
+	_ptr += len;
+	_pos += len;
+
+	return data;
+}
+
 bool MemoryReadStream::seek(int64 offs, int whence) {
 	// Pre-Condition
 	assert(_pos <= _size);
@@ -287,6 +298,21 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::borrow(uint32 len) {
+	if (len > _end - _pos)
+		return nullptr;
+
+	// Also repositions the parent stream for SafeSeekableSubReadStream
+	if (!_parentStream->seek(_pos))
+		return nullptr;
+
+	const byte *data = _parentStream->borrow(len);
+	if (data)
+		_pos += len;
+
+	return data;
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
@@ -603,4 +629,9 @@ uint32 SafeMutexedSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return Common::SafeSeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+const byte *SafeMutexedSeekableSubReadStream::borrow(uint32 len) {
+	Common::StackLock lock(_mutex);
+	return Common::SafeSeekableSubReadStream::borrow(len);
+}
+
 } // End of namespace Common
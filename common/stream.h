@@ -792,6 +792,25 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Borrow the next @p len bytes of the stream without copying them.
+	 *
+	 * If the stream has the data in memory as one contiguous block, e.g.
+	 * because it reads from a buffer or a memory mapped file, return a
+	 * pointer to it and advance the position indicator by @p len, just like
+	 * read() would. Otherwise, or if fewer than @p len bytes are left, return
+	 * nullptr without changing the position; the caller must then read() the
+	 * data into its own buffer.
+	 *
+	 * The memory must not be modified. It stays valid until the stream (or
+	 * the stream it reads from) is destroyed.
+	 *
+	 * @param len	Number of bytes to borrow.
+	 *
+	 * @return Pointer to the data, or nullptr if it can't be borrowed.
+	 */
+	virtual const byte *borrow(uint32 len) { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
@@ -982,6 +1001,7 @@ public:
 	int64 pos() const override { return _parentStream->pos(); }
 	int64 size() const override { return _parentStream->size(); }
 	bool seek(int64 offset, int whence = SEEK_SET) override { return _parentStream->seek(offset, whence); }
+	const byte *borrow(uint32 len) override { return _parentStream->borrow(len); }
 };
 
 /** @} */
@@ -373,13 +373,14 @@ Common::Error AdvancedMetaEngineDetection::createInstance(OSystem *syst, Engine
 	// the _directoryGlobsMap
 	preprocessDescriptions();
 
+	// Clear md5 cache before each detection starts, just in case.
+	// This also drops any directory listings of a previous detection.
+	ADCacheMan.clear();
+
 	// Compose a hashmap of all files in fslist.
 	FileMap allFiles;
 	composeFileHashMap(allFiles, files, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
 
-	// Clear md5 cache before each detection starts, just in case.
-	ADCacheMan.clear();
-
 	// Run the detector on this
 	ADDetectedGames matches = detectGame(files.begin()->getParent(), allFiles, language, platform, extra);
 
@@ -490,11 +491,7 @@ void AdvancedMetaEngineDetection::composeFileHashMap(FileMap &allFiles, const Co
 			if (!_globsMap.contains(efname))
 				continue;
 
-			Common::FSList files;
-			if (!file->getChildren(files, Common::FSNode::kListAll))
-				continue;
-
-			composeFileHashMap(allFiles, files, depth - 1, tstr);
+			composeFileHashMap(allFiles, ADCacheMan.getChildren(*file), depth - 1, tstr);
 			continue;
 		}
 
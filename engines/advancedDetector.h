@@ -571,7 +571,7 @@ protected:
 };
 
 /**
- * Singleton Cache Storage for Computed MD5s and Open Archives
+ * Singleton Cache Storage for Computed MD5s, Open Archives and Directory Listings
  */
 class AdvancedDetectorCacheManager : public Common::Singleton<AdvancedDetectorCacheManager> {
 public:
@@ -612,6 +612,22 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
+	/**
+	 * List the contents of a subdirectory of the game directory. Every engine
+	 * scans the same subdirectories, so they are only listed by the first one.
+	 */
+	const Common::FSList &getChildren(const Common::FSNode &node) {
+		Common::Path path = node.getPath();
+		DirectoryHashMap::const_iterator i = directoryHashMap.find(path);
+		if (i != directoryHashMap.end())
+			return i->_value;
+
+		Common::FSList &files = directoryHashMap[path];
+		if (!node.getChildren(files, Common::FSNode::kListAll))
+			files.clear();
+		return files;
+	}
+
 	AdvancedDetectorCacheManager() {
 		clear();
 	}
@@ -626,6 +642,7 @@ public:
 	void clear() {
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
+		directoryHashMap.clear(true);
 		clearArchives();
 	}
 
@@ -635,9 +652,11 @@ private:
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
 	typedef Common::HashMap<Common::Path, Common::Archive *, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> ArchiveHashMap;
+	typedef Common::HashMap<Common::Path, Common::FSList, Common::Path::Hash> DirectoryHashMap;
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+	DirectoryHashMap directoryHashMap;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
@@ -98,10 +98,27 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
-	assert(!s->_executionStack.empty());
+/**
+ * Adds the canonic addresses of the references in @p refs which differ from
+ * the references themselves to @p canonicRefs. Together they hold the same
+ * addresses as normalizeAddresses() would return, without copying the
+ * (mostly canonic already) clones, lists, nodes and arrays.
+ */
+static void addCanonicAddresses(SegManager *segMan, const AddrSet &refs, AddrSet &canonicRefs) {
+	for (AddrSet::const_iterator i = refs.begin(); i != refs.end(); ++i) {
+		const reg_t reg = i->_key;
+		SegmentObj *mobj = segMan->getSegmentObj(reg.getSegment());
 
-	WorklistManager wm;
+		if (mobj) {
+			const reg_t canonic = mobj->findCanonicAddress(segMan, reg);
+			if (canonic != reg)
+				canonicRefs.setVal(canonic, true);
+		}
+	}
+}
+
+static void markActiveReferences(EngineState *s, WorklistManager &wm) {
+	assert(!s->_executionStack.empty());
 
 	// Initialize registers
 	wm.push(s->r_acc);
@@ -174,6 +191,11 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->processEngineHunkList(wm);
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+	markActiveReferences(s, wm);
 
 	return normalizeAddresses(s->_segMan, wm._map);
 }
@@ -191,7 +213,11 @@ void run_gc(EngineState *s) {
 #endif
 
 	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	WorklistManager wm;
+	markActiveReferences(s, wm);
+	const AddrSet &activeRefs = wm._map;
+	AddrSet canonicRefs;
+	addCanonicAddresses(segMan, activeRefs, canonicRefs);
 
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
@@ -210,20 +236,25 @@ void run_gc(EngineState *s) {
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
+				if (!activeRefs.contains(addr) && !canonicRefs.contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
 #endif
+					// Freeing a script deallocates its whole segment
+					if (!heap[seg])
+						break;
 				}
 			}
 
+			if (heap[seg])
+				mobj->compactFreeList();
 		}
 	}
 
-	delete activeRefs;
+	segMan->markHeapCollected();
 
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
@@ -74,6 +74,29 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_decodedInstructionIndex.clear();
+	_decodedInstructions.clear();
+}
+
+int Script::decodeInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]) {
+	const int size = readPMachineInstruction(getBuf(offset), extOpcode, opparams);
+
+	if (_decodedInstructionIndex.empty())
+		_decodedInstructionIndex.resize(getBufSize());
+
+	// The instructions of the remaining offsets are decoded every time, should
+	// a script ever exceed this
+	if (_decodedInstructions.size() < 0xFFFF && size <= 0xFF) {
+		DecodedInstruction instruction;
+		memcpy(instruction.opparams, opparams, sizeof(instruction.opparams));
+		instruction.extOpcode = extOpcode;
+		instruction.size = size;
+		_decodedInstructions.push_back(instruction);
+		_decodedInstructionIndex[offset] = _decodedInstructions.size();
+	}
+
+	return size;
 }
 
 enum {
@@ -93,6 +93,26 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * An instruction decoded by readPMachineInstruction().
+	 */
+	struct DecodedInstruction {
+		int16 opparams[4];
+		byte extOpcode;
+		byte size;
+	};
+
+	/**
+	 * The instructions executed so far, decoded once after the script patches
+	 * were applied. They are looked up by their offset through
+	 * _decodedInstructionIndex, where 0 means the one at an offset wasn't
+	 * decoded yet, and all others are the index in _decodedInstructions + 1.
+	 */
+	Common::Array<uint16> _decodedInstructionIndex;
+	Common::Array<DecodedInstruction> _decodedInstructions;
+
+	int decodeInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]);
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -131,6 +151,22 @@ public:
 		return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
 	}
 
+	/**
+	 * Reads the instruction at the given offset like readPMachineInstruction(),
+	 * but only decodes it the first time.
+	 * @return the size of the instruction in bytes
+	 */
+	int readInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]) {
+		if (offset < _decodedInstructionIndex.size() && _decodedInstructionIndex[offset]) {
+			const DecodedInstruction &instruction = _decodedInstructions[_decodedInstructionIndex[offset] - 1];
+			extOpcode = instruction.extOpcode;
+			memcpy(opparams, instruction.opparams, sizeof(instruction.opparams));
+			return instruction.size;
+		}
+
+		return decodeInstruction(offset, extOpcode, opparams);
+	}
+
 public:
 	Script();
 	~Script() override;
@@ -47,6 +47,11 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	_bitmapSegId = 0;
 #endif
 
+	memset(_selectorCache, 0, sizeof(_selectorCache));
+	_selectorCacheGeneration = 1;
+
+	_heapChanged = true;
+
 	createClassTable();
 }
 
@@ -79,6 +84,9 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	invalidateSelectorCache();
+	_heapChanged = true;
 }
 
 void SegManager::initSysStrings() {
@@ -122,6 +130,7 @@ SegmentId SegManager::allocSegment(SegmentObj *mobj) {
 		_heap.push_back(0);
 	}
 	_heap[id] = mobj;
+	_heapChanged = true;
 
 	return id;
 }
@@ -180,6 +189,8 @@ void SegManager::deallocate(SegmentId seg) {
 
 	delete mobj;
 	_heap[actualSegment] = nullptr;
+
+	invalidateSelectorCache();
 }
 
 bool SegManager::isHeapObject(reg_t pos) const {
@@ -459,6 +470,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	}
 
 	int offset = table->allocEntry();
+	_heapChanged = true;
 
 	reg_t addr = make_reg(_hunksSegId, offset);
 	Hunk &h = table->at(offset);
@@ -492,6 +504,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	}
 
 	int offset = table->allocEntry();
+	_heapChanged = true;
 
 	*addr = make_reg(_clonesSegId, offset);
 	return &table->at(offset);
@@ -508,6 +521,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	}
 
 	int offset = table->allocEntry();
+	_heapChanged = true;
 
 	*addr = make_reg(_listsSegId, offset);
 	return &table->at(offset);
@@ -524,6 +538,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	}
 
 	int offset = table->allocEntry();
+	_heapChanged = true;
 
 	*addr = make_reg(_nodesSegId, offset);
 	return &table->at(offset);
@@ -950,6 +965,7 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	}
 
 	int offset = table->allocEntry();
+	_heapChanged = true;
 
 	*addr = make_reg(_arraysSegId, offset);
 
@@ -1006,6 +1022,7 @@ SciBitmap *SegManager::allocateBitmap(reg_t *addr, const int16 width, const int1
 	}
 
 	int offset = table->allocEntry();
+	_heapChanged = true;
 
 	*addr = make_reg(_bitmapSegId, offset);
 	SciBitmap &bitmap = table->at(offset);
@@ -1099,6 +1116,8 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 		scr = allocateScript(scriptNum, segmentId);
 	}
 
+	invalidateSelectorCache();
+
 	scr->load(scriptNum, _resMan, _scriptPatcher, applyScriptPatches);
 	scr->initializeLocals(this);
 	scr->initializeClasses(this);
@@ -1129,6 +1148,7 @@ void SegManager::uninstantiateScript(int script_nr) {
 	for (uint i = 0; i < classTableSize(); i++)
 		if (getClass(i).reg.getSegment() == segmentId)
 			setClassOffset(i, NULL_REG);
+	invalidateSelectorCache();
 
 	if (getSciVersion() < SCI_VERSION_1_1)
 		uninstantiateScriptSci0(script_nr);
@@ -1137,6 +1157,7 @@ void SegManager::uninstantiateScript(int script_nr) {
 	if (!scr->getLockers()) {
 		// The actual script deletion seems to be done by SCI scripts themselves
 		scr->markDeleted();
+		_heapChanged = true;
 		debugC(kDebugLevelScripts, "Unloaded script 0x%x.", script_nr);
 	}
 }
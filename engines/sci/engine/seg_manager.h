@@ -460,7 +460,57 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * A result of lookupSelector() for an object and selector. It is only
+	 * valid while its generation equals the current one.
+	 */
+	struct SelectorCacheEntry {
+		reg_t obj;
+		Selector selector;
+		uint32 generation;
+		SelectorType type;
+		int varIndex;
+		reg_t funcAddress;
+	};
+
+	/**
+	 * Returns the entry of the selector cache which an object and selector
+	 * map to, which may hold the lookup of another pair.
+	 */
+	SelectorCacheEntry &getSelectorCacheEntry(reg_t obj, Selector selector) {
+		return _selectorCache[(obj.getSegment() * 61 + obj.getOffset() * 7 + selector) & (kSelectorCacheSize - 1)];
+	}
+
+	uint32 getSelectorCacheGeneration() const { return _selectorCacheGeneration; }
+
+	/**
+	 * Invalidates all cached selector lookups. This is necessary whenever
+	 * objects may be removed, or replaced by others at the same address,
+	 * which happens when scripts are loaded or unloaded and clones freed.
+	 */
+	void invalidateSelectorCache() { _selectorCacheGeneration++; }
+
+	/**
+	 * Returns whether anything was allocated or a script unloaded since the
+	 * last garbage collection. If not, the heap has not grown, and the
+	 * collection of objects which became unreachable since then may be
+	 * postponed until it does.
+	 */
+	bool hasHeapChangedSinceGC() const { return _heapChanged; }
+
+	/** Called by the garbage collector once it has swept the heap. */
+	void markHeapCollected() { _heapChanged = false; }
+
 private:
+	enum {
+		kSelectorCacheSize = 1024
+	};
+
+	SelectorCacheEntry _selectorCache[kSelectorCacheSize];
+	uint32 _selectorCacheGeneration;
+
+	bool _heapChanged;
+
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
@@ -142,6 +142,13 @@ public:
 	virtual Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const {
 		return Common::Array<reg_t>();
 	}
+
+	/**
+	 * Drops the free entries at the end of the segment, and lets the next
+	 * allocations reuse the lowest free entries first.
+	 * Used by the garbage collector, after it freed the unreferenced entries.
+	 */
+	virtual void compactFreeList() {}
 };
 
 struct LocalVariables : public SegmentObj {
@@ -305,6 +312,23 @@ public:
 		return tmp;
 	}
 
+	void compactFreeList() override {
+		uint newSize = _table.size();
+		while (newSize > 0 && !isValidEntry(newSize - 1))
+			newSize--;
+		_table.resize(newSize);
+
+		// Rebuild the list in ascending order, so that the table stays dense
+		// instead of reusing whichever entries were freed last
+		first_free = HEAPENTRY_INVALID;
+		for (int i = newSize - 1; i >= 0; i--) {
+			if (!isValidEntry(i)) {
+				_table[i].next_free = first_free;
+				first_free = i;
+			}
+		}
+	}
+
 	uint size() const { return _table.size(); }
 
 	T &at(uint index) { return *_table[index].data; }
@@ -337,34 +337,44 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x", PRINT_REG(obj_location));
 	}
 
-	index = obj->locateVarSelector(segMan, selectorId);
-
-	if (index >= 0) {
-		// Found it as a variable
-		if (varp) {
-			varp->obj = obj_location;
-			varp->varindex = index;
-		}
-		return kSelectorVariable;
-	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
+	// The same selectors are sent to the same objects over and over again,
+	// so the results are cached instead of searching the class chain again
+	SegManager::SelectorCacheEntry &cached = segMan->getSelectorCacheEntry(obj_location, selectorId);
+	if (cached.generation != segMan->getSelectorCacheGeneration() || cached.obj != obj_location || cached.selector != selectorId) {
+		cached.obj = obj_location;
+		cached.selector = selectorId;
+		cached.generation = segMan->getSelectorCacheGeneration();
+
+		index = obj->locateVarSelector(segMan, selectorId);
+
+		if (index >= 0) {
+			// Found it as a variable
+			cached.type = kSelectorVariable;
+			cached.varIndex = index;
+		} else {
+			// Check if it's a method, with recursive lookup in superclasses
+			cached.type = kSelectorNone;
+			while (obj) {
+				index = obj->funcSelectorPosition(selectorId);
+				if (index >= 0) {
+					cached.type = kSelectorMethod;
+					cached.funcAddress = obj->getFunction(index);
+					break;
+				} else {
+					obj = segMan->getObject(obj->getSuperClassSelector());
+				}
 			}
 		}
-
-		return kSelectorNone;
 	}
 
+	if (cached.type == kSelectorVariable && varp) {
+		varp->obj = obj_location;
+		varp->varindex = cached.varIndex;
+	} else if (cached.type == kSelectorMethod && fptr) {
+		*fptr = cached.funcAddress;
+	}
 
-//	return _lookupSelector_function(segMan, obj, selectorId, fptr);
+	return cached.type;
 }
 
 } // End of namespace Sci
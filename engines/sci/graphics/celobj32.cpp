@@ -33,6 +33,7 @@
 #include "graphics/larryScale.h"
 #include "common/config-manager.h"
 #include "common/gui_options.h"
+#include "common/system.h"
 
 namespace Sci {
 #pragma mark CelScaler
@@ -84,6 +85,7 @@ const CelScalerTable &CelScaler::getScalerTable(const Ratio &scaleX, const Ratio
 #pragma mark -
 #pragma mark CelObj
 bool CelObj::_drawBlackLines = false;
+CelObj::SkipRowFunc CelObj::_drawSkipRow = &CelObj::drawSkipRowGeneric;
 
 void CelObj::init() {
 	CelObj::deinit();
@@ -91,6 +93,14 @@ void CelObj::init() {
 	_nextCacheId = 1;
 	_scaler = new CelScaler();
 	_cache = new CelCache(100);
+
+	_drawSkipRow = &drawSkipRowGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) _drawSkipRow = &drawSkipRowNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) _drawSkipRow = &drawSkipRowSSE2;
+#endif
 }
 
 void CelObj::deinit() {
@@ -100,6 +110,14 @@ void CelObj::deinit() {
 	_cache = nullptr;
 }
 
+void CelObj::drawSkipRowGeneric(byte *target, const byte *source, const int16 width, const uint8 skipColor) {
+	for (int16 x = 0; x < width; ++x) {
+		if (source[x] != skipColor) {
+			target[x] = source[x];
+		}
+	}
+}
+
 #pragma mark -
 #pragma mark CelObj - Scalers
 
@@ -113,6 +131,7 @@ struct SCALER_NoScale {
 	const int16 _lastIndex;
 	const int16 _sourceX;
 	const int16 _sourceY;
+	byte _rowBuffer[kCelScalerTableSize];
 
 	SCALER_NoScale(const CelObj &celObj, const int16 maxWidth, const Common::Point &scaledPosition) :
 	_row(nullptr),
@@ -139,13 +158,22 @@ struct SCALER_NoScale {
 		}
 	}
 
-	inline byte read() {
-		assert(_row != _rowEdge);
-
+	/**
+	 * Returns the next @p width pixels of the current row. Unless the cel is
+	 * mirrored, these are read directly from the source data.
+	 */
+	inline const byte *readRow(const int16 width) {
 		if (FLIP) {
-			return *_row--;
+			assert(_row - width >= _rowEdge);
+			for (int16 i = 0; i < width; ++i) {
+				_rowBuffer[i] = *_row--;
+			}
+			return _rowBuffer;
 		} else {
-			return *_row++;
+			assert(_row + width <= _rowEdge);
+			const byte *row = _row;
+			_row += width;
+			return row;
 		}
 	}
 };
@@ -162,6 +190,7 @@ struct SCALER_Scale {
 	// image and takes precedence over _reader.
 	Common::SharedPtr<Buffer> _sourceBuffer;
 	int16 _x;
+	byte _rowBuffer[kCelScalerTableSize];
 	static int16 _valuesX[kCelScalerTableSize];
 	static int16 _valuesY[kCelScalerTableSize];
 
@@ -300,9 +329,15 @@ struct SCALER_Scale {
 		assert(_x >= _minX && _x <= _maxX);
 	}
 
-	inline byte read() {
-		assert(_x >= _minX && _x <= _maxX);
-		return _row[_valuesX[_x++]];
+	/** Returns the next @p width scaled pixels of the current row. */
+	inline const byte *readRow(const int16 width) {
+		assert(_x >= _minX && _x + width - 1 <= _maxX);
+		const int16 *valuesX = _valuesX + _x;
+		for (int16 i = 0; i < width; ++i) {
+			_rowBuffer[i] = _row[valuesX[i]];
+		}
+		_x += width;
+		return _rowBuffer;
 	}
 };
 
@@ -468,6 +503,16 @@ struct MAPPER_NoMD {
 			*target = translateMacColor(isMacSource, pixel);
 		}
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		if (isMacSource) {
+			for (int16 x = 0; x < width; ++x) {
+				draw(target + x, source[x], skipColor, isMacSource);
+			}
+		} else {
+			CelObj::_drawSkipRow(target, source, width, skipColor);
+		}
+	}
 };
 
 /**
@@ -478,6 +523,16 @@ struct MAPPER_NoMDNoSkip {
 	inline void draw(byte *target, const byte pixel, const uint8, const bool isMacSource) const {
 		*target = translateMacColor(isMacSource, pixel);
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		if (isMacSource) {
+			for (int16 x = 0; x < width; ++x) {
+				draw(target + x, source[x], skipColor, isMacSource);
+			}
+		} else {
+			memcpy(target, source, width);
+		}
+	}
 };
 
 /**
@@ -485,17 +540,30 @@ struct MAPPER_NoMDNoSkip {
  * remapping data, and remapping enabled.
  */
 struct MAPPER_Map {
+	GfxRemap32 *const _remap;
+	const uint8 _startColor;
+
+	MAPPER_Map() :
+	_remap(g_sci->_gfxRemap32),
+	_startColor(_remap->getStartColor()) {}
+
 	inline void draw(byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) const {
 		if (pixel != skipColor) {
 			// For some reason, SSCI never checks if the source pixel is *above*
 			// the range of remaps, so we do not either.
-			if (pixel < g_sci->_gfxRemap32->getStartColor()) {
+			if (pixel < _startColor) {
 				*target = translateMacColor(isMacSource, pixel);
-			} else if (g_sci->_gfxRemap32->remapEnabled(pixel)) {
-				*target = g_sci->_gfxRemap32->remapColor(translateMacColor(isMacSource, pixel), *target);
+			} else if (_remap->remapEnabled(pixel)) {
+				*target = _remap->remapColor(translateMacColor(isMacSource, pixel), *target);
 			}
 		}
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		for (int16 x = 0; x < width; ++x) {
+			draw(target + x, source[x], skipColor, isMacSource);
+		}
+	}
 };
 
 /**
@@ -503,13 +571,24 @@ struct MAPPER_Map {
  * remapping data, and remapping disabled.
  */
 struct MAPPER_NoMap {
+	const uint8 _startColor;
+
+	MAPPER_NoMap() :
+	_startColor(g_sci->_gfxRemap32->getStartColor()) {}
+
 	inline void draw(byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) const {
 		// For some reason, SSCI never checks if the source pixel is *above* the
 		// range of remaps, so we do not either.
-		if (pixel != skipColor && pixel < g_sci->_gfxRemap32->getStartColor()) {
+		if (pixel != skipColor && pixel < _startColor) {
 			*target = translateMacColor(isMacSource, pixel);
 		}
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		for (int16 x = 0; x < width; ++x) {
+			draw(target + x, source[x], skipColor, isMacSource);
+		}
+	}
 };
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
@@ -757,12 +836,9 @@ struct RENDERER {
 			}
 
 			_scaler.setTarget(targetRect.left, targetRect.top + y);
+			_mapper.drawRow(targetPixel, _scaler.readRow(targetWidth), targetWidth, _skipColor, _isMacSource);
 
-			for (int16 x = 0; x < targetWidth; ++x) {
-				_mapper.draw(targetPixel++, _scaler.read(), _skipColor, _isMacSource);
-			}
-
-			targetPixel += skipStride;
+			targetPixel += targetWidth + skipStride;
 		}
 	}
 };
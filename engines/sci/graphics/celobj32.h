@@ -262,6 +262,22 @@ protected:
 public:
 	static CelScaler *_scaler;
 
+	/**
+	 * Copies @p width pixels from @p source to @p target, except those of the
+	 * skip color. This draws the rows of transparent cels without remapping,
+	 * with SIMD implementations selected at runtime.
+	 */
+	typedef void (*SkipRowFunc)(byte *target, const byte *source, const int16 width, const uint8 skipColor);
+	static SkipRowFunc _drawSkipRow;
+
+	static void drawSkipRowGeneric(byte *target, const byte *source, const int16 width, const uint8 skipColor);
+#ifdef SCUMMVM_NEON
+	static void drawSkipRowNEON(byte *target, const byte *source, const int16 width, const uint8 skipColor);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void drawSkipRowSSE2(byte *target, const byte *source, const int16 width, const uint8 skipColor);
+#endif
+
 	/**
 	 * The basic identifying information for this cel. This information
 	 * effectively acts as a composite key for a cel object, and any cel object
@@ -0,0 +1,60 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "sci/graphics/celobj32.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Sci {
+
+void CelObj::drawSkipRowNEON(byte *target, const byte *source, const int16 width, const uint8 skipColor) {
+	const uint8x16_t skip = vdupq_n_u8(skipColor);
+
+	int16 x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const uint8x16_t pixels = vld1q_u8(source + x);
+		const uint8x16_t background = vld1q_u8(target + x);
+		vst1q_u8(target + x, vbslq_u8(vceqq_u8(pixels, skip), background, pixels));
+	}
+
+	drawSkipRowGeneric(target + x, source + x, width - x, skipColor);
+}
+
+} // End of namespace Sci
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -111,6 +111,19 @@ MODULE_OBJS += \
 	video/robot_decoder.o
 endif
 
+ifdef ENABLE_SCI32
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	graphics/celobj32_neon.o
+$(MODULE)/graphics/celobj32_neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	graphics/celobj32_sse2.o
+$(MODULE)/graphics/celobj32_sse2.o: CXXFLAGS += -msse2
+endif
+endif
+
 # This module can be built as a plugin
 ifeq ($(ENABLE_SCI), DYNAMIC_PLUGIN)
 PLUGIN := 1
@@ -1006,10 +1006,12 @@ ResourceManager::ResourceManager(const bool detectionMode) :
 	_detectionMode(detectionMode) {}
 
 void ResourceManager::init() {
-	_maxMemoryLRU = 256 * 1024; // 256KiB
+	setMaxMemoryLRU(256 * 1024); // 256KiB
+	for (int i = 0; i < kLRUPoolCount; i++) {
+		_memoryLRU[i] = 0;
+		_LRU[i].clear();
+	}
 	_memoryLocked = 0;
-	_memoryLRU = 0;
-	_LRU.clear();
 	_resMap.clear();
 	_audioMapSCI1 = nullptr;
 #ifdef ENABLE_SCI32
@@ -1080,7 +1082,7 @@ void ResourceManager::init() {
 	// cache, leading to constant decompression of picture resources
 	// and making the renderer very slow.
 	if (getSciVersion() >= SCI_VERSION_2) {
-		_maxMemoryLRU = 4096 * 1024; // 4MiB
+		setMaxMemoryLRU(4096 * 1024); // 4MiB
 	}
 
 	switch (_viewType) {
@@ -1124,13 +1126,34 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+void ResourceManager::setMaxMemoryLRU(int maxMemory) {
+	// The pools share the budget, audio gets a quarter of it
+	_maxMemoryLRU[kLRUPoolAudio] = maxMemory / 4;
+	_maxMemoryLRU[kLRUPoolDefault] = maxMemory - _maxMemoryLRU[kLRUPoolAudio];
+}
+
+ResourceManager::LRUPool ResourceManager::getLRUPool(ResourceType type) {
+	switch (type) {
+	case kResourceTypeWave:
+	case kResourceTypeAudio:
+	case kResourceTypeSync:
+	case kResourceTypeAudio36:
+	case kResourceTypeSync36:
+	case kResourceTypeRave:
+		return kLRUPoolAudio;
+	default:
+		return kLRUPoolDefault;
+	}
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
-	_memoryLRU -= res->size();
+	const LRUPool pool = getLRUPool(res->getType());
+	_LRU[pool].erase(res->_lruPosition);
+	_memoryLRU[pool] -= res->size();
 	res->_status = kResStatusAllocated;
 }
 
@@ -1139,25 +1162,29 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
-	_memoryLRU += res->size();
+	const LRUPool pool = getLRUPool(res->getType());
+	_LRU[pool].push_front(res);
+	res->_lruPosition = _LRU[pool].begin();
+	_memoryLRU[pool] += res->size();
 #ifdef SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
 	      res->_id.toString().c_str(), res->size,
-	      _memoryLRU);
+	      _memoryLRU[pool]);
 #endif
 	res->_status = kResStatusEnqueued;
 }
 
 void ResourceManager::freeOldResources() {
-	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
-		removeFromLRU(goner);
-		goner->unalloc();
+	for (int pool = 0; pool < kLRUPoolCount; pool++) {
+		while (_maxMemoryLRU[pool] < _memoryLRU[pool]) {
+			assert(!_LRU[pool].empty());
+			Resource *goner = _LRU[pool].back();
+			removeFromLRU(goner);
+			goner->unalloc();
 #ifdef SCI_VERBOSE_RESMAN
-		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
+			debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
+		}
 	}
 }
 
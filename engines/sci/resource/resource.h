@@ -309,6 +309,7 @@ protected:
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
+	Common::List<Resource *>::iterator _lruPosition; /**< Position in the LRU list, while enqueued */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
@@ -489,18 +490,30 @@ public:
 protected:
 	bool _detectionMode;
 
-	// Maximum number of bytes to allow being allocated for resources
+	/**
+	 * The unlocked resources are kept in separate LRU lists, so that playing
+	 * long speech or sound samples, which are mostly used only once, does not
+	 * push the graphics and scripts of the current room out of memory.
+	 */
+	enum LRUPool {
+		kLRUPoolDefault,
+		kLRUPoolAudio,
+		kLRUPoolCount
+	};
+
+	// Maximum number of bytes to allow being allocated for resources, per pool,
+	// see setMaxMemoryLRU()
 	// Note: maxMemory will not be interpreted as a hard limit, only as a restriction
 	// for resources which are not explicitly locked. However, a warning will be
 	// issued whenever this limit is exceeded.
-	int _maxMemoryLRU;
+	int _maxMemoryLRU[kLRUPoolCount];
 
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	typedef Common::List<ResourceSource *> SourcesList;
 	SourcesList _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
-	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	int _memoryLRU[kLRUPoolCount];		///< Amount of resource bytes under LRU control
+	Common::List<Resource *> _LRU[kLRUPoolCount]; ///< Last Resource Used lists
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -643,6 +656,10 @@ protected:
 	 */
 	bool hasOldScriptHeader();
 
+	static LRUPool getLRUPool(ResourceType type);
+
+	/** Split the budget of @p maxMemory bytes for unlocked resources between the pools. */
+	void setMaxMemoryLRU(int maxMemory);
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
 
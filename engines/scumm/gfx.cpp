@@ -217,7 +217,12 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_vertStripNextInc = 0;
 	_zbufferDisabled = false;
 	_objectMode = false;
+	_roomBackgroundMode = false;
 	_distaff = false;
+
+	_stripCacheSize = 0;
+	_stripCachePalettePtr = nullptr;
+	memset(_stripCachePalette, 0, sizeof(_stripCachePalette));
 }
 
 Gdi::~Gdi() {
@@ -287,6 +292,7 @@ void Gdi::init() {
 }
 
 void Gdi::roomChanged(byte *roomptr) {
+	clearStripCache();
 }
 
 void GdiNES::roomChanged(byte *roomptr) {
@@ -1059,6 +1065,8 @@ void ScummEngine::initBGBuffers(int height) {
 	}
 	assert(_gdi->_numZBuffer >= 1 && _gdi->_numZBuffer <= 8);
 
+	_gdi->clearStripCache();
+
 	if (_game.version >= 7)
 		itemsize = (_roomHeight + 10) * _gdi->_numStrips;
 	else
@@ -1171,7 +1179,7 @@ void ScummEngine::redrawBGStrip(int start, int num) {
 	else
 		room = getResourceAddress(rtRoom, _roomResource);
 
-	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, 0);
+	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, Gdi::dbRoomBackground);
 }
 
 void ScummEngine::restoreBackground(Common::Rect rect, byte backColor) {
@@ -2140,6 +2148,7 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	_vertStripNextInc = height * vs->pitch - 1 * vs->format.bytesPerPixel;
 
 	_objectMode = (flag & dbObjectMode) == dbObjectMode;
+	_roomBackgroundMode = (flag & dbRoomBackground) != 0;
 	prepareDrawBitmap(ptr, vs, x, y, width, height, stripnr, numstrip);
 
 	sx = x - vs->xstart / 8;
@@ -2316,7 +2325,86 @@ bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width,
 		return result;
 	}
 
-	return decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+	if (!canCacheStrip(vs))
+		return decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+
+	if (drawCachedStrip(dstPtr, vs, stripnr, smap_ptr, height))
+		return false;
+
+	const bool transpStrip = decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+	if (!transpStrip)
+		cacheStrip(dstPtr, vs, stripnr, smap_ptr, height);
+	return transpStrip;
+}
+
+bool Gdi::canCacheStrip(const VirtScreen *vs) const {
+	// The pixels of the HE 16-bit games are looked up in a palette while
+	// decoding, not only mapped through the room palette
+	return _roomBackgroundMode && vs->format.bytesPerPixel == 1;
+}
+
+void Gdi::clearStripCache() {
+	_stripCache.clear();
+	_stripCacheSize = 0;
+	_stripCachePalettePtr = nullptr;
+}
+
+bool Gdi::drawCachedStrip(byte *dstPtr, const VirtScreen *vs, int stripnr, const byte *smap_ptr, int height) {
+	if (stripnr < 0 || stripnr >= (int)_stripCache.size())
+		return false;
+
+	const CachedStrip &strip = _stripCache[stripnr];
+	if (strip.smap != smap_ptr || strip.height != height)
+		return false;
+
+	// The decoders map the colors through the room palette, which the
+	// scripts may change at any time
+	if (_roomPalette != _stripCachePalettePtr || memcmp(_roomPalette, _stripCachePalette, sizeof(_stripCachePalette))) {
+		clearStripCache();
+		return false;
+	}
+
+	const byte *src = strip.pixels.data();
+	for (int h = 0; h < height; h++) {
+		memcpy(dstPtr, src, 8);
+		dstPtr += vs->pitch;
+		src += 8;
+	}
+	return true;
+}
+
+void Gdi::cacheStrip(const byte *dstPtr, const VirtScreen *vs, int stripnr, const byte *smap_ptr, int height) {
+	if (stripnr < 0)
+		return;
+
+	if (_roomPalette != _stripCachePalettePtr || memcmp(_roomPalette, _stripCachePalette, sizeof(_stripCachePalette))) {
+		clearStripCache();
+		_stripCachePalettePtr = _roomPalette;
+		memcpy(_stripCachePalette, _roomPalette, sizeof(_stripCachePalette));
+	}
+
+	if (stripnr >= (int)_stripCache.size())
+		_stripCache.resize(stripnr + 1);
+
+	CachedStrip &strip = _stripCache[stripnr];
+	_stripCacheSize -= strip.pixels.size();
+	if (_stripCacheSize + 8 * height > kMaxStripCacheSize) {
+		strip.smap = nullptr;
+		strip.pixels.clear();
+		return;
+	}
+
+	strip.smap = smap_ptr;
+	strip.height = height;
+	strip.pixels.resize(8 * height);
+	_stripCacheSize += strip.pixels.size();
+
+	byte *dst = strip.pixels.data();
+	for (int h = 0; h < height; h++) {
+		memcpy(dst, dstPtr, 8);
+		dstPtr += vs->pitch;
+		dst += 8;
+	}
 }
 
 bool GdiNES::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
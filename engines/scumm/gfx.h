@@ -23,6 +23,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -304,6 +305,37 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/** Flag which is true when the room background is being rendered, false otherwise. */
+	bool _roomBackgroundMode;
+
+	/**
+	 * A decoded strip of the room background. Only opaque strips are kept,
+	 * as the pixels of transparent ones depend on what was drawn before.
+	 */
+	struct CachedStrip {
+		const byte *smap; ///< The SMAP block of the strip, or nullptr if unused
+		int height;
+		Common::Array<byte> pixels; ///< 8 bytes per line
+	};
+
+	/**
+	 * The decoded strips of the room background, indexed by strip number,
+	 * so that scrolling back and redrawing dirty strips does not decompress
+	 * them again. Cleared when the room or the room palette changes.
+	 */
+	Common::Array<CachedStrip> _stripCache;
+	uint32 _stripCacheSize; ///< Number of bytes of pixels in the cache
+	const byte *_stripCachePalettePtr; ///< The room palette the strips were decoded with...
+	byte _stripCachePalette[256]; ///< ...and a copy of its colors
+
+	enum {
+		kMaxStripCacheSize = 1024 * 1024
+	};
+
+	bool canCacheStrip(const VirtScreen *vs) const;
+	bool drawCachedStrip(byte *dstPtr, const VirtScreen *vs, int stripnr, const byte *smap_ptr, int height);
+	void cacheStrip(const byte *dstPtr, const VirtScreen *vs, int stripnr, const byte *smap_ptr, int height);
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -360,6 +392,7 @@ public:
 
 	virtual void init();
 	virtual void roomChanged(byte *roomptr);
+	void clearStripCache();
 	virtual void loadTiles(byte *roomptr);
 	void setTransparentColor(byte transparentColor) { _transparentColor = transparentColor; }
 
@@ -378,9 +411,10 @@ public:
 	void resetBackground(int top, int bottom, int strip);
 
 	enum DrawBitmapFlags {
-		dbAllowMaskOr   = 1 << 0,
-		dbDrawMaskOnAll = 1 << 1,
-		dbObjectMode    = 2 << 2
+		dbAllowMaskOr    = 1 << 0,
+		dbDrawMaskOnAll  = 1 << 1,
+		dbObjectMode     = 2 << 2,
+		dbRoomBackground = 1 << 4
 	};
 };
 
@@ -73,6 +73,13 @@ int MoviePlayer::load(const Common::Path &filename, int flags, int image) {
 	// Ensure that Bink will use our PixelFormat
 	_video->setOutputPixelFormat(g_system->getScreenFormat());
 
+#ifdef USE_BINK
+	// The Bink videos are high resolution, decode frames ahead while the
+	// engine waits for the next tick, see waitForTimer_useIdleTime()
+	if (_vm->_game.heversion >= 100 && (_vm->_game.features & GF_16BIT_COLOR))
+		_video->setDecodeAhead(4);
+#endif
+
 	_video->start();
 
 	debug(1, "Playing video %s", filename.toString().c_str());
@@ -178,6 +185,10 @@ void MoviePlayer::handleNextFrame() {
 		_video->close();
 }
 
+bool MoviePlayer::decodeAhead() {
+	return _video->isVideoLoaded() && _video->decodeAhead();
+}
+
 void MoviePlayer::close() {
 	_video->close();
 }
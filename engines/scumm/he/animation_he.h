@@ -58,6 +58,7 @@ public:
 
 	void copyFrameToBuffer(byte *dst, int dstType, uint x, uint y, uint pitch);
 	void handleNextFrame();
+	bool decodeAhead();
 
 	void close();
 	int getWidth() const;
@@ -679,6 +679,7 @@ protected:
 
 	void scummLoop(int delta) override;
 	void scummLoop_handleDrawing() override;
+	bool waitForTimer_useIdleTime() override;
 	void runBootscript() override;
 
 	void processInput() override;
@@ -24,6 +24,7 @@
 #include "common/debug-channels.h"
 #include "common/macresman.h"
 #include "common/md5.h"
+#include "common/prefetch.h"
 #include "common/events.h"
 #include "common/system.h"
 #include "common/translation.h"
@@ -2525,6 +2526,9 @@ void ScummEngine::waitForTimer(int quarterFrames, bool freezeMacGui) {
 		_refreshDuration[_refreshArrayPos] = (int)(cur - screenUpdateTimerStart);
 		_refreshArrayPos = (_refreshArrayPos + 1) % ARRAYSIZE(_refreshDuration);
 #endif
+		while (cur < endTime && waitForTimer_useIdleTime())
+			cur = _system->getMillis();
+
 		if (cur >= endTime)
 			break;
 		_system->delayMillis(MIN<uint32>(10, endTime - cur));
@@ -2541,6 +2545,10 @@ void ScummEngine::waitForTimer(int quarterFrames, bool freezeMacGui) {
 	_lastWaitTime = (cur > endTime + 50) ? cur : endTime;
 }
 
+bool ScummEngine::waitForTimer_useIdleTime() {
+	return Common::readAhead();
+}
+
 uint32 ScummEngine::getIntegralTime(double fMsecs) {
 	double msecIntPart;
 	_msecFractParts += modf(fMsecs, &msecIntPart);
@@ -2820,6 +2828,10 @@ void ScummEngine_v90he::scummLoop(int delta) {
 		_logicHE->endOfFrame();
 	}
 }
+
+bool ScummEngine_v90he::waitForTimer_useIdleTime() {
+	return _moviePlay->decodeAhead() || ScummEngine_v80he::waitForTimer_useIdleTime();
+}
 #endif
 
 void ScummEngine::scummLoop_updateScummVars() {
@@ -636,6 +636,14 @@ protected:
 	void waitForTimer(int quarterFrames, bool freezeMacGui = false);
 	uint32 _lastWaitTime;
 
+	/**
+	 * Called by waitForTimer() while there is time left, to get some work
+	 * done ahead. Return false if there is nothing to do, in which case
+	 * waitForTimer() sleeps instead. By default, this reads ahead for the
+	 * compressed speech, see Common::readAhead().
+	 */
+	virtual bool waitForTimer_useIdleTime();
+
 	void setTimerAndShakeFrequency();
 
 	/**
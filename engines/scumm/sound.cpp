@@ -22,6 +22,7 @@
 #include "common/config-manager.h"
 #include "common/timer.h"
 #include "common/util.h"
+#include "common/prefetch.h"
 #include "common/ptr.h"
 #include "common/substream.h"
 
@@ -641,6 +642,17 @@ static Audio::AudioStream *checkForBrokenIndy4Sample(Common::SeekableReadStream
 	);
 }
 
+#if defined(USE_MAD) || defined(USE_VORBIS) || defined(USE_FLAC)
+static Common::SeekableReadStream *openCompressedSpeech(Common::SeekableReadStream *file, uint32 offset, int size) {
+	// The speech is decoded on the audio thread. Read it ahead in the idle
+	// time of the engine, so that the audio thread doesn't have to wait for
+	// slow storage.
+	return Common::wrapPrefetchingSeekableReadStream(
+		new Common::SeekableSubReadStream(file, offset, offset + size, DisposeAfterUse::YES),
+		32 * 1024, DisposeAfterUse::YES);
+}
+#endif
+
 void Sound::startTalkSound(uint32 offset, uint32 length, int mode, Audio::SoundHandle *handle) {
 	int num = 0, i;
 	int id = -1;
@@ -871,7 +883,7 @@ void Sound::startTalkSound(uint32 offset, uint32 length, int mode, Audio::SoundH
 #ifdef USE_MAD
 			{
 			assert(size > 0);
-			input = Audio::makeMP3Stream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			input = Audio::makeMP3Stream(openCompressedSpeech(file.release(), offset, size), DisposeAfterUse::YES);
 			}
 #endif
 			break;
@@ -879,7 +891,7 @@ void Sound::startTalkSound(uint32 offset, uint32 length, int mode, Audio::SoundH
 #ifdef USE_VORBIS
 			{
 			assert(size > 0);
-			input = Audio::makeVorbisStream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			input = Audio::makeVorbisStream(openCompressedSpeech(file.release(), offset, size), DisposeAfterUse::YES);
 			}
 #endif
 			break;
@@ -887,7 +899,7 @@ void Sound::startTalkSound(uint32 offset, uint32 length, int mode, Audio::SoundH
 #ifdef USE_FLAC
 			{
 			assert(size > 0);
-			input = Audio::makeFLACStream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			input = Audio::makeFLACStream(openCompressedSpeech(file.release(), offset, size), DisposeAfterUse::YES);
 			}
 #endif
 			break;
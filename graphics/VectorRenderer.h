@@ -492,6 +492,34 @@ public:
 	 */
 	virtual void drawStep(const Common::Rect &area, const Common::Rect &clip, const DrawStep &step, uint32 extra = 0);
 
+	/**
+	 * Sets up the renderer for the specified draw step the same way drawStep()
+	 * does, without drawing anything. Used when the result of a step is
+	 * already available, to keep the state the following steps inherit.
+	 */
+	void applyStepState(const Common::Rect &area, const Common::Rect &clip, const DrawStep &step, uint32 extra = 0);
+
+	/**
+	 * The state a draw step inherits from the ones drawn before it: the
+	 * colors it doesn't set itself.
+	 */
+	struct InheritedState {
+		uint32 fgColor, bgColor, bevelColor;
+		uint32 gradientStart, gradientEnd;
+		bool disableShadows;
+
+		bool operator==(const InheritedState &state) const {
+			return fgColor == state.fgColor && bgColor == state.bgColor && bevelColor == state.bevelColor &&
+				gradientStart == state.gradientStart && gradientEnd == state.gradientEnd &&
+				disableShadows == state.disableShadows;
+		}
+	};
+
+	/**
+	 * Returns the state the next draw step inherits.
+	 */
+	virtual InheritedState getInheritedState() const = 0;
+
 	/**
 	 * Copies the part of the current frame to the system overlay.
 	 *
@@ -81,6 +81,17 @@ public:
 	void setBgColor(uint8 r, uint8 g, uint8 b) override { _bgColor = _format.RGBToColor(r, g, b); }
 	void setBevelColor(uint8 r, uint8 g, uint8 b) override { _bevelColor = _format.RGBToColor(r, g, b); }
 	void setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2) override;
+
+	InheritedState getInheritedState() const override {
+		InheritedState state;
+		state.fgColor = _fgColor;
+		state.bgColor = _bgColor;
+		state.bevelColor = _bevelColor;
+		state.gradientStart = _gradientStart;
+		state.gradientEnd = _gradientEnd;
+		state.disableShadows = Base::_disableShadows;
+		return state;
+	}
 	void setClippingRect(const Common::Rect &clippingArea) override { _clippingArea = clippingArea; }
 
 	void copyFrame(OSystem *sys, const Common::Rect &r) override;
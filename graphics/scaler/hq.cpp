@@ -21,6 +21,7 @@
 #include "graphics/scaler/hq.h"
 #include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
+#include "common/system.h"
 
 // RGB-to-YUV lookup table
 
@@ -110,6 +111,26 @@ void HQScaler::initLUT(Graphics::PixelFormat format) {
 #endif
 }
 
+static void computePatternsGeneric(byte *patterns, const uint32 *yuvTop, const uint32 *yuvMid, const uint32 *yuvBottom, int width) {
+	HQPatterns::computeGeneric(patterns, yuvTop, yuvMid, yuvBottom, 0, width);
+}
+
+HQPatterns::PatternFunc HQPatterns::getPatternFunc() {
+	PatternFunc patternFunc = &computePatternsGeneric;
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) patternFunc = getPatternFuncNEON();
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) patternFunc = getPatternFuncSSE2();
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) patternFunc = getPatternFuncAVX2();
+#endif
+
+	return patternFunc;
+}
+
 #define interpolate_1_1(a,b)         (ColorMask::kBytesPerPixel == 2 ? interpolate16_1_1<ColorMask>(a,b) : interpolate32_1_1<ColorMask>(a,b))
 #define interpolate_3_1(a,b)         (ColorMask::kBytesPerPixel == 2 ? interpolate16_3_1<ColorMask>(a,b) : interpolate32_3_1<ColorMask>(a,b))
 #define interpolate_7_1(a,b)         (ColorMask::kBytesPerPixel == 2 ? interpolate16_7_1<ColorMask>(a,b) : interpolate32_7_1<ColorMask>(a,b))
@@ -173,7 +194,12 @@ void HQScaler::initLUT(Graphics::PixelFormat format) {
 #define PIXEL11_90	*(q+1+nextlineDst) = interpolate_2_3_3(w5, w6, w8);
 #define PIXEL11_100	*(q+1+nextlineDst) = interpolate_14_1_1(w5, w6, w8);
 
-#define YUV(x)	(sizeof(Pixel) == 2 ? RGBtoYUV[w ## x] : ConvertYUV<ColorMask>(w ## x, RGBtoYUV))
+// The YUV values of the neighbours of the current pixel, from the converted rows
+#define YUV(x)	YUV ## x
+#define YUV2	yuvTop[x]
+#define YUV4	yuvMid[x - 1]
+#define YUV6	yuvMid[x + 1]
+#define YUV8	yuvBottom[x]
 
 /**
  * Convert 32 bit RGB values to Yuv
@@ -193,13 +219,23 @@ static inline uint32 ConvertYUV(uint32 x, const uint32 *RGBtoYUV) {
 	return RGBtoYUV[r | g | b];
 }
 
+/**
+ * Convert a row of @p width pixels, plus the pixels left and right of it, to
+ * Yuv
+ */
+template<typename ColorMask>
+static inline void convertRowYUV(uint32 *yuv, const typename ColorMask::PixelType *src, int width, const uint32 *RGBtoYUV) {
+	for (int x = -1; x <= width; x++)
+		yuv[x] = (sizeof(typename ColorMask::PixelType) == 2 ? RGBtoYUV[src[x]] : ConvertYUV<ColorMask>(src[x], RGBtoYUV));
+}
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (https://web.archive.org/web/20090204033742/http://www.hiend3d.com/hq2x.html).
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, HQRows &rows) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -221,6 +257,22 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	if (width <= 0 || height <= 0)
+		return;
+
+	// The YUV values of the rows above, at and below the current one, with
+	// one pixel of border on both sides
+	const int yuvPitch = width + 2;
+	rows.yuv.resize(3 * yuvPitch);
+	rows.patterns.resize(width);
+	uint32 *yuvTop = &rows.yuv[1];
+	uint32 *yuvMid = yuvTop + yuvPitch;
+	uint32 *yuvBottom = yuvMid + yuvPitch;
+	byte *patterns = &rows.patterns[0];
+
+	convertRowYUV<ColorMask>(yuvTop, p - nextlineSrc, width, RGBtoYUV);
+	convertRowYUV<ColorMask>(yuvMid, p, width, RGBtoYUV);
+
 	while (height--) {
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
@@ -230,26 +282,17 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w5 = *(p);
 		w8 = *(p + nextlineSrc);
 
-		int tmpWidth = width;
-		while (tmpWidth--) {
+		convertRowYUV<ColorMask>(yuvBottom, p + nextlineSrc, width, RGBtoYUV);
+		rows.computePatterns(patterns, yuvTop, yuvMid, yuvBottom, width);
+
+		for (int x = 0; x < width; x++) {
 			p++;
 
 			w3 = *(p - nextlineSrc);
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
-
-			switch (pattern) {
+			switch (patterns[x]) {
 			case 0:
 			case 1:
 			case 4:
@@ -2053,6 +2096,11 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		}
 		p += nextlineSrc - width;
 		q += (nextlineDst - width) * 2;
+
+		uint32 *yuvFree = yuvTop;
+		yuvTop = yuvMid;
+		yuvMid = yuvBottom;
+		yuvBottom = yuvFree;
 	}
 }
 
@@ -2116,7 +2164,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, HQRows &rows) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int  w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -2139,6 +2187,22 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	if (width <= 0 || height <= 0)
+		return;
+
+	// The YUV values of the rows above, at and below the current one, with
+	// one pixel of border on both sides
+	const int yuvPitch = width + 2;
+	rows.yuv.resize(3 * yuvPitch);
+	rows.patterns.resize(width);
+	uint32 *yuvTop = &rows.yuv[1];
+	uint32 *yuvMid = yuvTop + yuvPitch;
+	uint32 *yuvBottom = yuvMid + yuvPitch;
+	byte *patterns = &rows.patterns[0];
+
+	convertRowYUV<ColorMask>(yuvTop, p - nextlineSrc, width, RGBtoYUV);
+	convertRowYUV<ColorMask>(yuvMid, p, width, RGBtoYUV);
+
 	while (height--) {
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
@@ -2148,26 +2212,17 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w5 = *(p);
 		w8 = *(p + nextlineSrc);
 
-		int tmpWidth = width;
-		while (tmpWidth--) {
+		convertRowYUV<ColorMask>(yuvBottom, p + nextlineSrc, width, RGBtoYUV);
+		rows.computePatterns(patterns, yuvTop, yuvMid, yuvBottom, width);
+
+		for (int x = 0; x < width; x++) {
 			p++;
 
 			w3 = *(p - nextlineSrc);
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
-
-			switch (pattern) {
+			switch (patterns[x]) {
 			case 0:
 			case 1:
 			case 4:
@@ -4944,6 +4999,11 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		}
 		p += nextlineSrc - width;
 		q += (nextlineDst - width) * 3;
+
+		uint32 *yuvFree = yuvTop;
+		yuvTop = yuvMid;
+		yuvMid = yuvBottom;
+		yuvBottom = yuvFree;
 	}
 }
 
@@ -4953,6 +5013,7 @@ HQScaler::HQScaler(const Graphics::PixelFormat &format) : Scaler(format),
 #endif
 	_RGBtoYUV(nullptr) {
 	_factor = 2;
+	_rows.computePatterns = HQPatterns::getPatternFunc();
 
 	if (format.bytesPerPixel == 2) {
 		initLUT(format);
@@ -4987,19 +5048,19 @@ void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _rows);
 	else
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _rows);
 }
 
 void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ3x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _rows);
 	else
 		HQ3x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _rows);
 }
 #endif
 
@@ -5007,15 +5068,15 @@ void HQScaler::HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ2x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _rows);
 		} else {
 			HQ2x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _rows);
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ2x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _rows);
 	}
 }
 
@@ -5023,15 +5084,15 @@ void HQScaler::HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ3x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _rows);
 		} else {
 			HQ3x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _rows);
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ3x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _rows);
 	}
 }
 
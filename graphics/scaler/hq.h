@@ -22,6 +22,7 @@
 #define GRAPHICS_SCALER_HQ_H
 
 #include "graphics/scalerplugin.h"
+#include "graphics/scaler/hq_intern.h"
 
 #ifdef USE_NASM
 struct hqx_parameters;
@@ -44,6 +45,7 @@ protected:
 	inline void HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
 
 	uint32 *_RGBtoYUV;
+	HQRows _rows;
 #ifdef USE_NASM
 	hqx_parameters *_hqx_params;
 #endif
@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/hq_intern.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+class HQPatternsImpl_AVX2 {
+	// The bit of the pattern if diffYUV(yuv5, yuv) is true
+	static FORCEINLINE __m256i diff(__m256i yuv5, const uint32 *yuv, __m256i thresholds, __m256i bit) {
+		const __m256i other = _mm256_loadu_si256((const __m256i *)yuv);
+		const __m256i absDiff = _mm256_or_si256(_mm256_subs_epu8(yuv5, other), _mm256_subs_epu8(other, yuv5));
+		const __m256i same = _mm256_cmpeq_epi32(_mm256_subs_epu8(absDiff, thresholds), _mm256_setzero_si256());
+		return _mm256_andnot_si256(same, bit);
+	}
+
+	static FORCEINLINE __m256i pattern(const uint32 *yuvTop, const uint32 *yuvMid, const uint32 *yuvBottom, __m256i thresholds) {
+		const __m256i yuv5 = _mm256_loadu_si256((const __m256i *)yuvMid);
+		__m256i result = diff(yuv5, yuvTop - 1, thresholds, _mm256_set1_epi32(0x01));
+		result = _mm256_or_si256(result, diff(yuv5, yuvTop, thresholds, _mm256_set1_epi32(0x02)));
+		result = _mm256_or_si256(result, diff(yuv5, yuvTop + 1, thresholds, _mm256_set1_epi32(0x04)));
+		result = _mm256_or_si256(result, diff(yuv5, yuvMid - 1, thresholds, _mm256_set1_epi32(0x08)));
+		result = _mm256_or_si256(result, diff(yuv5, yuvMid + 1, thresholds, _mm256_set1_epi32(0x10)));
+		result = _mm256_or_si256(result, diff(yuv5, yuvBottom - 1, thresholds, _mm256_set1_epi32(0x20)));
+		result = _mm256_or_si256(result, diff(yuv5, yuvBottom, thresholds, _mm256_set1_epi32(0x40)));
+		return _mm256_or_si256(result, diff(yuv5, yuvBottom + 1, thresholds, _mm256_set1_epi32(0x80)));
+	}
+
+public:
+	static void compute(byte *patterns, const uint32 *yuvTop, const uint32 *yuvMid, const uint32 *yuvBottom, int width) {
+		const __m256i thresholds = _mm256_set1_epi32((int)HQPatterns::kThresholds);
+
+		int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			const __m256i lo = pattern(yuvTop + x, yuvMid + x, yuvBottom + x, thresholds);
+			const __m256i hi = pattern(yuvTop + x + 8, yuvMid + x + 8, yuvBottom + x + 8, thresholds);
+			// The packs work per 128-bit lane, so restore the order of the words in between
+			const __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+			const __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+			_mm_storeu_si128((__m128i *)(patterns + x), bytes);
+		}
+
+		HQPatterns::computeGeneric(patterns, yuvTop, yuvMid, yuvBottom, x, width);
+	}
+};
+
+HQPatterns::PatternFunc HQPatterns::getPatternFuncAVX2() {
+	return &HQPatternsImpl_AVX2::compute;
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,97 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRAPHICS_SCALER_HQ_INTERN_H
+#define GRAPHICS_SCALER_HQ_INTERN_H
+
+#include "common/array.h"
+#include "graphics/scaler/intern.h"
+
+/**
+ * The neighbour patterns of the hq scalers. The pattern of pixel w5 has one
+ * bit for each of its neighbours, from the lowest bit on in the order w1, w2,
+ * w3, w4, w6, w7, w8 and w9, which is set if diffYUV() considers the YUV
+ * values of the pixel and the neighbour different:
+ *
+ *	w1 w2 w3
+ *	w4 w5 w6
+ *	w7 w8 w9
+ *
+ * The patterns of a whole row are computed at once from the YUV values of
+ * the row and of the rows above and below it, with SIMD implementations
+ * selected at runtime.
+ */
+class HQPatterns {
+public:
+	/**
+	 * Compute the patterns of @p width pixels. The YUV rows must be readable
+	 * from index -1 to @p width.
+	 */
+	typedef void (*PatternFunc)(byte *patterns, const uint32 *yuvTop, const uint32 *yuvMid, const uint32 *yuvBottom, int width);
+
+	/** Return the fastest pattern function supported by the CPU. */
+	static PatternFunc getPatternFunc();
+
+#ifdef SCUMMVM_NEON
+	static PatternFunc getPatternFuncNEON();
+#endif
+#ifdef SCUMMVM_SSE2
+	static PatternFunc getPatternFuncSSE2();
+#endif
+#ifdef SCUMMVM_AVX2
+	static PatternFunc getPatternFuncAVX2();
+#endif
+
+	/**
+	 * The diffYUV() thresholds of the V, U and Y bytes of a YUV value, minus
+	 * one. The vector implementations compare the absolute byte differences
+	 * with it, the unused top byte never differs.
+	 */
+	static const uint32 kThresholds = 0xFF300706;
+
+	/**
+	 * The reference implementation. The SIMD versions use it for the pixels
+	 * which don't fill a whole vector, starting at pixel @p x.
+	 */
+	static void computeGeneric(byte *patterns, const uint32 *yuvTop, const uint32 *yuvMid, const uint32 *yuvBottom, int x, int width) {
+		for (; x < width; x++) {
+			const int yuv5 = yuvMid[x];
+			int pattern = 0;
+			if (diffYUV(yuv5, yuvTop[x - 1])) pattern |= 0x0001;
+			if (diffYUV(yuv5, yuvTop[x])) pattern |= 0x0002;
+			if (diffYUV(yuv5, yuvTop[x + 1])) pattern |= 0x0004;
+			if (diffYUV(yuv5, yuvMid[x - 1])) pattern |= 0x0008;
+			if (diffYUV(yuv5, yuvMid[x + 1])) pattern |= 0x0010;
+			if (diffYUV(yuv5, yuvBottom[x - 1])) pattern |= 0x0020;
+			if (diffYUV(yuv5, yuvBottom[x])) pattern |= 0x0040;
+			if (diffYUV(yuv5, yuvBottom[x + 1])) pattern |= 0x0080;
+			patterns[x] = pattern;
+		}
+	}
+};
+
+/** The per row buffers of the hq scalers, kept between calls. */
+struct HQRows {
+	Common::Array<uint32> yuv;    ///< Three rows of YUV values
+	Common::Array<byte> patterns; ///< The patterns of the current row
+	HQPatterns::PatternFunc computePatterns;
+};
+
+#endif
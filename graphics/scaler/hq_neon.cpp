@@ -0,0 +1,82 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/scaler/hq_intern.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+class HQPatternsImpl_NEON {
+	// The bit of the pattern if diffYUV(yuv5, yuv) is true
+	static FORCEINLINE uint32x4_t diff(uint8x16_t yuv5, const uint32 *yuv, uint8x16_t thresholds, uint32x4_t bit) {
+		const uint8x16_t other = vreinterpretq_u8_u32(vld1q_u32(yuv));
+		const uint32x4_t over = vreinterpretq_u32_u8(vqsubq_u8(vabdq_u8(yuv5, other), thresholds));
+		return vandq_u32(vtstq_u32(over, over), bit);
+	}
+
+	static FORCEINLINE uint16x4_t pattern(const uint32 *yuvTop, const uint32 *yuvMid, const uint32 *yuvBottom, uint8x16_t thresholds) {
+		const uint8x16_t yuv5 = vreinterpretq_u8_u32(vld1q_u32(yuvMid));
+		uint32x4_t result = diff(yuv5, yuvTop - 1, thresholds, vdupq_n_u32(0x01));
+		result = vorrq_u32(result, diff(yuv5, yuvTop, thresholds, vdupq_n_u32(0x02)));
+		result = vorrq_u32(result, diff(yuv5, yuvTop + 1, thresholds, vdupq_n_u32(0x04)));
+		result = vorrq_u32(result, diff(yuv5, yuvMid - 1, thresholds, vdupq_n_u32(0x08)));
+		result = vorrq_u32(result, diff(yuv5, yuvMid + 1, thresholds, vdupq_n_u32(0x10)));
+		result = vorrq_u32(result, diff(yuv5, yuvBottom - 1, thresholds, vdupq_n_u32(0x20)));
+		result = vorrq_u32(result, diff(yuv5, yuvBottom, thresholds, vdupq_n_u32(0x40)));
+		result = vorrq_u32(result, diff(yuv5, yuvBottom + 1, thresholds, vdupq_n_u32(0x80)));
+		return vmovn_u32(result);
+	}
+
+public:
+	static void compute(byte *patterns, const uint32 *yuvTop, const uint32 *yuvMid, const uint32 *yuvBottom, int width) {
+		const uint8x16_t thresholds = vreinterpretq_u8_u32(vdupq_n_u32(HQPatterns::kThresholds));
+
+		int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const uint16x4_t lo = pattern(yuvTop + x, yuvMid + x, yuvBottom + x, thresholds);
+			const uint16x4_t hi = pattern(yuvTop + x + 4, yuvMid + x + 4, yuvBottom + x + 4, thresholds);
+			vst1_u8(patterns + x, vmovn_u16(vcombine_u16(lo, hi)));
+		}
+
+		HQPatterns::computeGeneric(patterns, yuvTop, yuvMid, yuvBottom, x, width);
+	}
+};
+
+HQPatterns::PatternFunc HQPatterns::getPatternFuncNEON() {
+	return &HQPatternsImpl_NEON::compute;
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
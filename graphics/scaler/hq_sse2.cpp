@@ -0,0 +1,79 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/hq_intern.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+class HQPatternsImpl_SSE2 {
+	// The bit of the pattern if diffYUV(yuv5, yuv) is true
+	static FORCEINLINE __m128i diff(__m128i yuv5, const uint32 *yuv, __m128i thresholds, __m128i bit) {
+		const __m128i other = _mm_loadu_si128((const __m128i *)yuv);
+		const __m128i absDiff = _mm_or_si128(_mm_subs_epu8(yuv5, other), _mm_subs_epu8(other, yuv5));
+		const __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(absDiff, thresholds), _mm_setzero_si128());
+		return _mm_andnot_si128(same, bit);
+	}
+
+	static FORCEINLINE __m128i pattern(const uint32 *yuvTop, const uint32 *yuvMid, const uint32 *yuvBottom, __m128i thresholds) {
+		const __m128i yuv5 = _mm_loadu_si128((const __m128i *)yuvMid);
+		__m128i result = diff(yuv5, yuvTop - 1, thresholds, _mm_set1_epi32(0x01));
+		result = _mm_or_si128(result, diff(yuv5, yuvTop, thresholds, _mm_set1_epi32(0x02)));
+		result = _mm_or_si128(result, diff(yuv5, yuvTop + 1, thresholds, _mm_set1_epi32(0x04)));
+		result = _mm_or_si128(result, diff(yuv5, yuvMid - 1, thresholds, _mm_set1_epi32(0x08)));
+		result = _mm_or_si128(result, diff(yuv5, yuvMid + 1, thresholds, _mm_set1_epi32(0x10)));
+		result = _mm_or_si128(result, diff(yuv5, yuvBottom - 1, thresholds, _mm_set1_epi32(0x20)));
+		result = _mm_or_si128(result, diff(yuv5, yuvBottom, thresholds, _mm_set1_epi32(0x40)));
+		return _mm_or_si128(result, diff(yuv5, yuvBottom + 1, thresholds, _mm_set1_epi32(0x80)));
+	}
+
+public:
+	static void compute(byte *patterns, const uint32 *yuvTop, const uint32 *yuvMid, const uint32 *yuvBottom, int width) {
+		const __m128i thresholds = _mm_set1_epi32((int)HQPatterns::kThresholds);
+
+		int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const __m128i lo = pattern(yuvTop + x, yuvMid + x, yuvBottom + x, thresholds);
+			const __m128i hi = pattern(yuvTop + x + 4, yuvMid + x + 4, yuvBottom + x + 4, thresholds);
+			const __m128i words = _mm_packs_epi32(lo, hi);
+			_mm_storel_epi64((__m128i *)(patterns + x), _mm_packus_epi16(words, words));
+		}
+
+		HQPatterns::computeGeneric(patterns, yuvTop, yuvMid, yuvBottom, x, width);
+	}
+};
+
+HQPatterns::PatternFunc HQPatterns::getPatternFuncSSE2() {
+	return &HQPatternsImpl_SSE2::compute;
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -33,9 +33,6 @@
 
 namespace TinyGL {
 
-Common::Point transformPoint(float x, float y, int rotation);
-Common::Rect rotateRectangle(int x, int y, int width, int height, int rotation, int originX, int originY);
-
 struct BlitImage {
 public:
 	BlitImage() : _isDisposed(false), _version(0), _binaryTransparent(false), _opaque(true), _zBuffer(false), _refcount(1) { }
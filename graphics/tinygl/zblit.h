@@ -31,6 +31,12 @@ namespace TinyGL {
 
 struct BlitImage;
 
+Common::Point transformPoint(float x, float y, int rotation);
+/**
+@brief Returns the bounding box of a rectangle rotated by the given angle around the given origin.
+*/
+Common::Rect rotateRectangle(int x, int y, int width, int height, int rotation, int originX, int originY);
+
 namespace Internal {
 	/**
 	@brief Performs a cleanup of disposed blit images.
@@ -56,6 +56,11 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_currentTexture = nullptr;
 
 	_enableScissor = false;
+
+	for (int mode = DRAW_DEPTH_ONLY; mode <= DRAW_SMOOTH; mode++) {
+		for (int depthWrite = 0; depthWrite < 2; depthWrite++)
+			_fillSpan[mode][depthWrite] = _pbufBpp == 4 ? Span::getFillFunc(mode, depthWrite) : nullptr;
+	}
 }
 
 FrameBuffer::~FrameBuffer() {
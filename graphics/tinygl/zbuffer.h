@@ -31,6 +31,7 @@
 #include "graphics/surface.h"
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
 
 #include "common/rect.h"
 
@@ -758,6 +759,9 @@ private:
 	Common::Rect _clipRectangle;
 	bool _enableScissor;
 
+	// SIMD span functions by draw mode and depth write, for 32-bit buffers
+	Span::FillFunc _fillSpan[3][2];
+
 	const TexelBuffer *_currentTexture;
 	uint _wrapS, _wrapT;
 	bool _blendingEnabled;
@@ -662,6 +662,16 @@ void BlittingDrawCall::computeDirtyRegion() {
 	}
 	if (blitWidth == 0 || blitHeight == 0) {
 		_dirtyRegion = Common::Rect();
+	} else if (_transform._rotation != 0) {
+		// Rotated blits fill the bounding box of the rotated image, which is
+		// larger than the image, from the clipped destination position
+		const Common::Rect &renderRect = gl_get_context()->renderRect;
+		Common::Rect rotated = rotateRectangle(0, 0, blitWidth, blitHeight, _transform._rotation,
+		                                       _transform._originX, _transform._originY);
+		int left = MAX<int>(_transform._destinationRectangle.left, renderRect.left);
+		int top = MAX<int>(_transform._destinationRectangle.top, renderRect.top);
+		_dirtyRegion = Common::Rect(left, top, left + rotated.width() + 1, top + rotated.height() + 1);
+		_dirtyRegion.clip(renderRect);
 	} else {
 		_dirtyRegion = Common::Rect(
 			_transform._destinationRectangle.left,
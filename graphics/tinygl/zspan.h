@@ -0,0 +1,155 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H
+#define GRAPHICS_TINYGL_ZSPAN_H
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+#include "graphics/tinygl/gl.h"
+
+namespace TinyGL {
+
+/**
+ * The state of a span which stays the same for all of its pixels: the depth
+ * comparison and the 32-bit format of the frame buffer.
+ */
+struct SpanParams {
+	// The depth test passes if the stored depth is less, equal or greater
+	// than the one of the pixel, as selected by these flags
+	bool depthLess, depthEqual, depthGreater;
+	byte rLoss, gLoss, bLoss, aLoss;
+	byte rShift, gShift, bShift, aShift;
+
+	SpanParams(const Graphics::PixelFormat &format, bool depthTestEnabled, int depthFunc) :
+		rLoss(format.rLoss), gLoss(format.gLoss), bLoss(format.bLoss), aLoss(format.aLoss),
+		rShift(format.rShift), gShift(format.gShift), bShift(format.bShift), aShift(format.aShift) {
+		if (!depthTestEnabled)
+			depthFunc = TGL_ALWAYS;
+		depthLess = depthFunc == TGL_LESS || depthFunc == TGL_LEQUAL || depthFunc == TGL_NOTEQUAL || depthFunc == TGL_ALWAYS;
+		depthEqual = depthFunc == TGL_EQUAL || depthFunc == TGL_LEQUAL || depthFunc == TGL_GEQUAL || depthFunc == TGL_ALWAYS;
+		depthGreater = depthFunc == TGL_GREATER || depthFunc == TGL_GEQUAL || depthFunc == TGL_NOTEQUAL || depthFunc == TGL_ALWAYS;
+	}
+};
+
+/** The interpolated values at the first pixel of a span, and their steps. */
+struct SpanInterpolants {
+	uint z, r, g, b, a;
+	int dzdx, drdx, dgdx, dbdx, dadx;
+};
+
+/**
+ * Untextured spans of the triangle rasterizer, without blending, alpha test,
+ * fog, stencil or scissor, written to a 32-bit frame buffer. These are
+ * depth-only, flat and smooth shaded spans (DRAW_DEPTH_ONLY, DRAW_FLAT and
+ * DRAW_SMOOTH), with SIMD implementations selected at runtime.
+ *
+ * All implementations must produce the same output as the per pixel code
+ * of FrameBuffer::fillTriangle(). That includes storing the depth of colored
+ * pixels through a float, as FrameBuffer::writePixel() does.
+ */
+class Span {
+public:
+	/**
+	 * Draw @p count pixels to @p pixels and @p zbuf, starting with the
+	 * values of @p start.
+	 */
+	typedef void (*FillFunc)(uint32 *pixels, uint *zbuf, int count, const SpanInterpolants &start, const SpanParams &params);
+
+	/**
+	 * Return the fastest span function for the draw mode supported by the
+	 * CPU, or nullptr if there is none, in which case the per pixel code is
+	 * used.
+	 */
+	static FillFunc getFillFunc(int drawMode, bool depthWrite);
+
+#ifdef SCUMMVM_NEON
+	static FillFunc getFillFuncNEON(int drawMode, bool depthWrite);
+#endif
+#ifdef SCUMMVM_SSE2
+	static FillFunc getFillFuncSSE2(int drawMode, bool depthWrite);
+#endif
+#ifdef SCUMMVM_AVX2
+	static FillFunc getFillFuncAVX2(int drawMode, bool depthWrite);
+#endif
+
+	/** Same as FrameBuffer::compareDepth(). */
+	static inline bool depthTest(uint z, uint zDst, const SpanParams &params) {
+		return zDst < z ? params.depthLess : zDst == z ? params.depthEqual : params.depthGreater;
+	}
+
+	/**
+	 * The reference implementation. The SIMD versions use it for the pixels
+	 * which don't fill a whole vector, starting at pixel @p x.
+	 */
+	template<bool kInterpRGB, bool kSmoothMode, bool kDepthWrite>
+	static void fillGeneric(uint32 *pixels, uint *zbuf, int x, int count, const SpanInterpolants &start, const SpanParams &params) {
+		uint z = start.z + (uint)x * start.dzdx;
+		uint r = start.r, g = start.g, b = start.b, a = start.a;
+		if (kSmoothMode) {
+			r += (uint)x * start.drdx;
+			g += (uint)x * start.dgdx;
+			b += (uint)x * start.dbdx;
+			a += (uint)x * start.dadx;
+		}
+		for (; x < count; x++) {
+			if (depthTest(z, zbuf[x], params)) {
+				if (kInterpRGB) {
+					if (kDepthWrite)
+						zbuf[x] = (uint)(float)z;
+					pixels[x] = ((byte)(a >> 8) >> params.aLoss) << params.aShift |
+					            ((byte)(r >> 8) >> params.rLoss) << params.rShift |
+					            ((byte)(g >> 8) >> params.gLoss) << params.gShift |
+					            ((byte)(b >> 8) >> params.bLoss) << params.bShift;
+				} else if (kDepthWrite) {
+					zbuf[x] = z;
+				}
+			}
+			z += start.dzdx;
+			if (kSmoothMode) {
+				r += start.drdx;
+				g += start.dgdx;
+				b += start.dbdx;
+				a += start.dadx;
+			}
+		}
+	}
+
+	/**
+	 * Helper for the SIMD implementations: returns the instantiation of
+	 * @p Impl::fill for the draw mode.
+	 */
+	template<class Impl>
+	static FillFunc selectFillFunc(int drawMode, bool depthWrite) {
+		switch (drawMode) {
+		case 0: // DRAW_DEPTH_ONLY
+			return depthWrite ? &Impl::template fill<false, false, true> : &Impl::template fill<false, false, false>;
+		case 1: // DRAW_FLAT
+			return depthWrite ? &Impl::template fill<true, false, true> : &Impl::template fill<true, false, false>;
+		default: // DRAW_SMOOTH
+			return depthWrite ? &Impl::template fill<true, true, true> : &Impl::template fill<true, true, false>;
+		}
+	}
+};
+
+} // end of namespace TinyGL
+
+#endif
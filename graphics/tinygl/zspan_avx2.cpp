@@ -0,0 +1,153 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zspan.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace TinyGL {
+
+class SpanImpl_AVX2 {
+	// Same as Span::depthTest(), AVX2 only compares signed integers
+	static FORCEINLINE __m256i depthTest(__m256i z, __m256i zDst, __m256i less, __m256i equal, __m256i greater) {
+		const __m256i sign = _mm256_set1_epi32((int)0x80000000);
+		const __m256i zSigned = _mm256_xor_si256(z, sign);
+		const __m256i zDstSigned = _mm256_xor_si256(zDst, sign);
+		__m256i mask = _mm256_and_si256(_mm256_cmpgt_epi32(zSigned, zDstSigned), less);
+		mask = _mm256_or_si256(mask, _mm256_and_si256(_mm256_cmpeq_epi32(z, zDst), equal));
+		return _mm256_or_si256(mask, _mm256_and_si256(_mm256_cmpgt_epi32(zDstSigned, zSigned), greater));
+	}
+
+	// (uint)(float)z, with the rounding of the unsigned to float conversion
+	static FORCEINLINE __m256i roundDepth(__m256i z) {
+		// Both halves convert exactly, so the sum is rounded only once
+		__m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(z, 16)), _mm256_set1_ps(65536.0f));
+		f = _mm256_add_ps(f, _mm256_cvtepi32_ps(_mm256_and_si256(z, _mm256_set1_epi32(0xFFFF))));
+		// Values from 2^31 on don't fit the signed conversion back
+		const __m256 big = _mm256_cmp_ps(f, _mm256_set1_ps(2147483648.0f), _CMP_GE_OQ);
+		f = _mm256_sub_ps(f, _mm256_and_ps(big, _mm256_set1_ps(2147483648.0f)));
+		return _mm256_xor_si256(_mm256_cvttps_epi32(f), _mm256_slli_epi32(_mm256_castps_si256(big), 31));
+	}
+
+	// Same as PixelFormat::ARGBToColor() on the 8 integer bits of a component
+	static FORCEINLINE __m256i component(__m256i value, __m128i loss, __m128i shift) {
+		value = _mm256_and_si256(_mm256_srli_epi32(value, 8), _mm256_set1_epi32(0xFF));
+		return _mm256_sll_epi32(_mm256_srl_epi32(value, loss), shift);
+	}
+
+	static FORCEINLINE __m256i select(__m256i mask, __m256i a, __m256i b) {
+		return _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b));
+	}
+
+	// The values of 8 consecutive pixels
+	static FORCEINLINE __m256i ramp(uint value, int step) {
+		return _mm256_setr_epi32(value, value + step, value + 2 * (uint)step, value + 3 * (uint)step,
+		                         value + 4 * (uint)step, value + 5 * (uint)step, value + 6 * (uint)step, value + 7 * (uint)step);
+	}
+
+public:
+template<bool kInterpRGB, bool kSmoothMode, bool kDepthWrite>
+static void fill(uint32 *pixels, uint *zbuf, int count, const SpanInterpolants &start, const SpanParams &params) {
+	if (!kInterpRGB && !kDepthWrite)
+		return;
+
+	const __m256i less = _mm256_set1_epi32(params.depthLess ? -1 : 0);
+	const __m256i equal = _mm256_set1_epi32(params.depthEqual ? -1 : 0);
+	const __m256i greater = _mm256_set1_epi32(params.depthGreater ? -1 : 0);
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i aLoss = _mm_cvtsi32_si128(params.aLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(params.aShift);
+
+	__m256i z = ramp(start.z, start.dzdx);
+	const __m256i dz = _mm256_set1_epi32(8 * (uint)start.dzdx);
+
+	__m256i r, g, b, a, dr, dg, db, da;
+	__m256i color = _mm256_setzero_si256();
+	if (kSmoothMode) {
+		r = ramp(start.r, start.drdx);
+		g = ramp(start.g, start.dgdx);
+		b = ramp(start.b, start.dbdx);
+		a = ramp(start.a, start.dadx);
+		dr = _mm256_set1_epi32(8 * (uint)start.drdx);
+		dg = _mm256_set1_epi32(8 * (uint)start.dgdx);
+		db = _mm256_set1_epi32(8 * (uint)start.dbdx);
+		da = _mm256_set1_epi32(8 * (uint)start.dadx);
+	} else if (kInterpRGB) {
+		color = _mm256_or_si256(_mm256_or_si256(component(_mm256_set1_epi32(start.r), rLoss, rShift), component(_mm256_set1_epi32(start.g), gLoss, gShift)),
+		                     _mm256_or_si256(component(_mm256_set1_epi32(start.b), bLoss, bShift), component(_mm256_set1_epi32(start.a), aLoss, aShift)));
+	}
+
+	int x = 0;
+	for (; x + 8 <= count; x += 8) {
+		const __m256i zDst = _mm256_loadu_si256((const __m256i *)(zbuf + x));
+		const __m256i mask = depthTest(z, zDst, less, equal, greater);
+
+		// Skip the hidden parts of a triangle quickly
+		if (_mm256_movemask_epi8(mask)) {
+			if (kInterpRGB) {
+				if (kSmoothMode) {
+					color = _mm256_or_si256(_mm256_or_si256(component(r, rLoss, rShift), component(g, gLoss, gShift)),
+					                     _mm256_or_si256(component(b, bLoss, bShift), component(a, aLoss, aShift)));
+				}
+				const __m256i dst = _mm256_loadu_si256((const __m256i *)(pixels + x));
+				_mm256_storeu_si256((__m256i *)(pixels + x), select(mask, color, dst));
+				if (kDepthWrite)
+					_mm256_storeu_si256((__m256i *)(zbuf + x), select(mask, roundDepth(z), zDst));
+			} else {
+				_mm256_storeu_si256((__m256i *)(zbuf + x), select(mask, z, zDst));
+			}
+		}
+
+		z = _mm256_add_epi32(z, dz);
+		if (kSmoothMode) {
+			r = _mm256_add_epi32(r, dr);
+			g = _mm256_add_epi32(g, dg);
+			b = _mm256_add_epi32(b, db);
+			a = _mm256_add_epi32(a, da);
+		}
+	}
+
+	Span::fillGeneric<kInterpRGB, kSmoothMode, kDepthWrite>(pixels, zbuf, x, count, start, params);
+}
+
+}; // End of class SpanImpl_AVX2
+
+Span::FillFunc Span::getFillFuncAVX2(int drawMode, bool depthWrite) {
+	return selectFillFunc<SpanImpl_AVX2>(drawMode, depthWrite);
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,149 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/tinygl/zspan.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace TinyGL {
+
+class SpanImpl_NEON {
+	// Same as Span::depthTest()
+	static FORCEINLINE uint32x4_t depthTest(uint32x4_t z, uint32x4_t zDst, uint32x4_t less, uint32x4_t equal, uint32x4_t greater) {
+		uint32x4_t mask = vandq_u32(vcltq_u32(zDst, z), less);
+		mask = vorrq_u32(mask, vandq_u32(vceqq_u32(zDst, z), equal));
+		return vorrq_u32(mask, vandq_u32(vcgtq_u32(zDst, z), greater));
+	}
+
+	static FORCEINLINE bool anyLane(uint32x4_t mask) {
+		const uint32x2_t half = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+		return (vget_lane_u32(half, 0) | vget_lane_u32(half, 1)) != 0;
+	}
+
+	// Same as PixelFormat::ARGBToColor() on the 8 integer bits of a component
+	static FORCEINLINE uint32x4_t component(uint32x4_t value, int32x4_t loss, int32x4_t shift) {
+		value = vandq_u32(vshrq_n_u32(value, 8), vdupq_n_u32(0xFF));
+		return vshlq_u32(vshlq_u32(value, loss), shift);
+	}
+
+	// The values of 4 consecutive pixels
+	static FORCEINLINE uint32x4_t ramp(uint value, int step) {
+		const uint32 values[4] = { value, value + step, value + 2 * (uint)step, value + 3 * (uint)step };
+		return vld1q_u32(values);
+	}
+
+public:
+template<bool kInterpRGB, bool kSmoothMode, bool kDepthWrite>
+static void fill(uint32 *pixels, uint *zbuf, int count, const SpanInterpolants &start, const SpanParams &params) {
+	if (!kInterpRGB && !kDepthWrite)
+		return;
+
+	const uint32x4_t less = vdupq_n_u32(params.depthLess ? 0xFFFFFFFF : 0);
+	const uint32x4_t equal = vdupq_n_u32(params.depthEqual ? 0xFFFFFFFF : 0);
+	const uint32x4_t greater = vdupq_n_u32(params.depthGreater ? 0xFFFFFFFF : 0);
+	// Negative shifts are right shifts
+	const int32x4_t rLoss = vdupq_n_s32(-params.rLoss);
+	const int32x4_t gLoss = vdupq_n_s32(-params.gLoss);
+	const int32x4_t bLoss = vdupq_n_s32(-params.bLoss);
+	const int32x4_t aLoss = vdupq_n_s32(-params.aLoss);
+	const int32x4_t rShift = vdupq_n_s32(params.rShift);
+	const int32x4_t gShift = vdupq_n_s32(params.gShift);
+	const int32x4_t bShift = vdupq_n_s32(params.bShift);
+	const int32x4_t aShift = vdupq_n_s32(params.aShift);
+
+	uint32x4_t z = ramp(start.z, start.dzdx);
+	const uint32x4_t dz = vdupq_n_u32(4 * (uint)start.dzdx);
+
+	uint32x4_t r, g, b, a, dr, dg, db, da;
+	uint32x4_t color = vdupq_n_u32(0);
+	if (kSmoothMode) {
+		r = ramp(start.r, start.drdx);
+		g = ramp(start.g, start.dgdx);
+		b = ramp(start.b, start.dbdx);
+		a = ramp(start.a, start.dadx);
+		dr = vdupq_n_u32(4 * (uint)start.drdx);
+		dg = vdupq_n_u32(4 * (uint)start.dgdx);
+		db = vdupq_n_u32(4 * (uint)start.dbdx);
+		da = vdupq_n_u32(4 * (uint)start.dadx);
+	} else if (kInterpRGB) {
+		color = vorrq_u32(vorrq_u32(component(vdupq_n_u32(start.r), rLoss, rShift), component(vdupq_n_u32(start.g), gLoss, gShift)),
+		                  vorrq_u32(component(vdupq_n_u32(start.b), bLoss, bShift), component(vdupq_n_u32(start.a), aLoss, aShift)));
+	}
+
+	int x = 0;
+	for (; x + 4 <= count; x += 4) {
+		const uint32x4_t zDst = vld1q_u32(zbuf + x);
+		const uint32x4_t mask = depthTest(z, zDst, less, equal, greater);
+
+		// Skip the hidden parts of a triangle quickly
+		if (anyLane(mask)) {
+			if (kInterpRGB) {
+				if (kSmoothMode) {
+					color = vorrq_u32(vorrq_u32(component(r, rLoss, rShift), component(g, gLoss, gShift)),
+					                  vorrq_u32(component(b, bLoss, bShift), component(a, aLoss, aShift)));
+				}
+				vst1q_u32(pixels + x, vbslq_u32(mask, color, vld1q_u32(pixels + x)));
+				// The same conversions as the scalar code uses on ARM
+				if (kDepthWrite)
+					vst1q_u32(zbuf + x, vbslq_u32(mask, vcvtq_u32_f32(vcvtq_f32_u32(z)), zDst));
+			} else {
+				vst1q_u32(zbuf + x, vbslq_u32(mask, z, zDst));
+			}
+		}
+
+		z = vaddq_u32(z, dz);
+		if (kSmoothMode) {
+			r = vaddq_u32(r, dr);
+			g = vaddq_u32(g, dg);
+			b = vaddq_u32(b, db);
+			a = vaddq_u32(a, da);
+		}
+	}
+
+	Span::fillGeneric<kInterpRGB, kSmoothMode, kDepthWrite>(pixels, zbuf, x, count, start, params);
+}
+
+}; // End of class SpanImpl_NEON
+
+Span::FillFunc Span::getFillFuncNEON(int drawMode, bool depthWrite) {
+	return selectFillFunc<SpanImpl_NEON>(drawMode, depthWrite);
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
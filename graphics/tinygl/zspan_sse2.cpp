@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zspan.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace TinyGL {
+
+class SpanImpl_SSE2 {
+	// Same as Span::depthTest(), SSE2 only compares signed integers
+	static FORCEINLINE __m128i depthTest(__m128i z, __m128i zDst, __m128i less, __m128i equal, __m128i greater) {
+		const __m128i sign = _mm_set1_epi32((int)0x80000000);
+		const __m128i zSigned = _mm_xor_si128(z, sign);
+		const __m128i zDstSigned = _mm_xor_si128(zDst, sign);
+		__m128i mask = _mm_and_si128(_mm_cmpgt_epi32(zSigned, zDstSigned), less);
+		mask = _mm_or_si128(mask, _mm_and_si128(_mm_cmpeq_epi32(z, zDst), equal));
+		return _mm_or_si128(mask, _mm_and_si128(_mm_cmpgt_epi32(zDstSigned, zSigned), greater));
+	}
+
+	// (uint)(float)z, with the rounding of the unsigned to float conversion
+	static FORCEINLINE __m128i roundDepth(__m128i z) {
+		// Both halves convert exactly, so the sum is rounded only once
+		__m128 f = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(z, 16)), _mm_set1_ps(65536.0f));
+		f = _mm_add_ps(f, _mm_cvtepi32_ps(_mm_and_si128(z, _mm_set1_epi32(0xFFFF))));
+		// Values from 2^31 on don't fit the signed conversion back
+		const __m128 big = _mm_cmpge_ps(f, _mm_set1_ps(2147483648.0f));
+		f = _mm_sub_ps(f, _mm_and_ps(big, _mm_set1_ps(2147483648.0f)));
+		return _mm_xor_si128(_mm_cvttps_epi32(f), _mm_slli_epi32(_mm_castps_si128(big), 31));
+	}
+
+	// Same as PixelFormat::ARGBToColor() on the 8 integer bits of a component
+	static FORCEINLINE __m128i component(__m128i value, __m128i loss, __m128i shift) {
+		value = _mm_and_si128(_mm_srli_epi32(value, 8), _mm_set1_epi32(0xFF));
+		return _mm_sll_epi32(_mm_srl_epi32(value, loss), shift);
+	}
+
+	static FORCEINLINE __m128i select(__m128i mask, __m128i a, __m128i b) {
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+
+	// The values of 4 consecutive pixels
+	static FORCEINLINE __m128i ramp(uint value, int step) {
+		return _mm_setr_epi32(value, value + step, value + 2 * (uint)step, value + 3 * (uint)step);
+	}
+
+public:
+template<bool kInterpRGB, bool kSmoothMode, bool kDepthWrite>
+static void fill(uint32 *pixels, uint *zbuf, int count, const SpanInterpolants &start, const SpanParams &params) {
+	if (!kInterpRGB && !kDepthWrite)
+		return;
+
+	const __m128i less = _mm_set1_epi32(params.depthLess ? -1 : 0);
+	const __m128i equal = _mm_set1_epi32(params.depthEqual ? -1 : 0);
+	const __m128i greater = _mm_set1_epi32(params.depthGreater ? -1 : 0);
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i aLoss = _mm_cvtsi32_si128(params.aLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(params.aShift);
+
+	__m128i z = ramp(start.z, start.dzdx);
+	const __m128i dz = _mm_set1_epi32(4 * (uint)start.dzdx);
+
+	__m128i r, g, b, a, dr, dg, db, da;
+	__m128i color = _mm_setzero_si128();
+	if (kSmoothMode) {
+		r = ramp(start.r, start.drdx);
+		g = ramp(start.g, start.dgdx);
+		b = ramp(start.b, start.dbdx);
+		a = ramp(start.a, start.dadx);
+		dr = _mm_set1_epi32(4 * (uint)start.drdx);
+		dg = _mm_set1_epi32(4 * (uint)start.dgdx);
+		db = _mm_set1_epi32(4 * (uint)start.dbdx);
+		da = _mm_set1_epi32(4 * (uint)start.dadx);
+	} else if (kInterpRGB) {
+		color = _mm_or_si128(_mm_or_si128(component(_mm_set1_epi32(start.r), rLoss, rShift), component(_mm_set1_epi32(start.g), gLoss, gShift)),
+		                     _mm_or_si128(component(_mm_set1_epi32(start.b), bLoss, bShift), component(_mm_set1_epi32(start.a), aLoss, aShift)));
+	}
+
+	int x = 0;
+	for (; x + 4 <= count; x += 4) {
+		const __m128i zDst = _mm_loadu_si128((const __m128i *)(zbuf + x));
+		const __m128i mask = depthTest(z, zDst, less, equal, greater);
+
+		// Skip the hidden parts of a triangle quickly
+		if (_mm_movemask_epi8(mask)) {
+			if (kInterpRGB) {
+				if (kSmoothMode) {
+					color = _mm_or_si128(_mm_or_si128(component(r, rLoss, rShift), component(g, gLoss, gShift)),
+					                     _mm_or_si128(component(b, bLoss, bShift), component(a, aLoss, aShift)));
+				}
+				const __m128i dst = _mm_loadu_si128((const __m128i *)(pixels + x));
+				_mm_storeu_si128((__m128i *)(pixels + x), select(mask, color, dst));
+				if (kDepthWrite)
+					_mm_storeu_si128((__m128i *)(zbuf + x), select(mask, roundDepth(z), zDst));
+			} else {
+				_mm_storeu_si128((__m128i *)(zbuf + x), select(mask, z, zDst));
+			}
+		}
+
+		z = _mm_add_epi32(z, dz);
+		if (kSmoothMode) {
+			r = _mm_add_epi32(r, dr);
+			g = _mm_add_epi32(g, dg);
+			b = _mm_add_epi32(b, db);
+			a = _mm_add_epi32(a, da);
+		}
+	}
+
+	Span::fillGeneric<kInterpRGB, kSmoothMode, kDepthWrite>(pixels, zbuf, x, count, start, params);
+}
+
+}; // End of class SpanImpl_SSE2
+
+Span::FillFunc Span::getFillFuncSSE2(int drawMode, bool depthWrite) {
+	return selectFillFunc<SpanImpl_SSE2>(drawMode, depthWrite);
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
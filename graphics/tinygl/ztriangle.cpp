@@ -26,6 +26,7 @@
  */
 
 #include "common/endian.h"
+#include "common/system.h"
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
@@ -34,6 +35,22 @@ namespace TinyGL {
 
 static const int NB_INTERP = 8;
 
+Span::FillFunc Span::getFillFunc(int drawMode, bool depthWrite) {
+	FillFunc fillFunc = nullptr;
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) fillFunc = getFillFuncNEON(drawMode, depthWrite);
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) fillFunc = getFillFuncSSE2(drawMode, depthWrite);
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) fillFunc = getFillFuncAVX2(drawMode, depthWrite);
+#endif
+
+	return fillFunc;
+}
+
 template <bool kDepthWrite, bool kSmoothMode, bool kFogMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
                                     int x, int y, uint &z, uint &r, uint &g, uint &b, uint &a,
@@ -325,6 +342,15 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+	// untextured spans without any per pixel state can be drawn by the SIMD
+	// span functions
+	const bool kSpanSupported = kInterpZ && !kInterpST && !kInterpSTZ && !kFogMode && !kAlphaTestEnabled &&
+	                            !kEnableScissor && !kBlendingEnabled && !kStencilEnabled;
+	Span::FillFunc fillSpan = nullptr;
+	if (kSpanSupported)
+		fillSpan = _fillSpan[!kInterpRGB ? DRAW_DEPTH_ONLY : kSmoothMode ? DRAW_SMOOTH : DRAW_FLAT][kDepthWrite];
+	const SpanParams spanParams(_pbufFormat, kDepthTestEnabled, _depthFunc);
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -424,7 +450,20 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kSpanSupported && fillSpan) {
+				SpanInterpolants span;
+				span.z = z1;
+				span.r = r1;
+				span.g = g1;
+				span.b = b1;
+				span.a = a1;
+				span.dzdx = dzdx;
+				span.drdx = drdx;
+				span.dgdx = dgdx;
+				span.dbdx = dbdx;
+				span.dadx = dadx;
+				fillSpan((uint32 *)_pbuf + pp1 + x1, pz1 + x1, (x2 >> 16) - x1 + 1, span, spanParams);
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
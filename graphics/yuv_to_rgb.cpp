@@ -82,8 +82,11 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/array.h"
+#include "common/system.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -99,12 +102,14 @@ public:
 	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
 	const int16 *getColorTable() const { return _colorTab; }
 	const byte *getClipTable() const { return _clipTable; }
+	const int16 *getOffsetTable() const { return _offsetTab; }
 
 private:
 	Graphics::PixelFormat _format;
 	YUVToRGBManager::LuminanceScale _scale;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	byte _clipTable[3 * 768];
+	int16 _offsetTab[4 * 256]; // _colorTab without the clip table offsets, for YUVToRGBRow
 };
 
 YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
@@ -169,15 +174,25 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	int16 *Cb_g_tab = &_colorTab[2 * 256];
 	int16 *Cb_b_tab = &_colorTab[3 * 256];
 
+	int16 *Cr_r_offset = &_offsetTab[0 * 256];
+	int16 *Cr_g_offset = &_offsetTab[1 * 256];
+	int16 *Cb_g_offset = &_offsetTab[2 * 256];
+	int16 *Cb_b_offset = &_offsetTab[3 * 256];
+
 	for (int i = 0; i < 256; i++) {
 		// Gamma correction (luminescence table) and chroma correction
 		// would be done here. See the Berkeley mpeg_play sources.
 
 		int16 CR = (i - 128), CB = CR;
-		Cr_r_tab[i] = (int16) ( (0.419 / 0.299) * CR) + r_offset + 256;
-		Cr_g_tab[i] = (int16) (-(0.299 / 0.419) * CR) + g_offset + 256;
-		Cb_g_tab[i] = (int16) (-(0.114 / 0.331) * CB);
-		Cb_b_tab[i] = (int16) ( (0.587 / 0.331) * CB) + b_offset + 256;
+		Cr_r_offset[i] = (int16) ( (0.419 / 0.299) * CR);
+		Cr_g_offset[i] = (int16) (-(0.299 / 0.419) * CR);
+		Cb_g_offset[i] = (int16) (-(0.114 / 0.331) * CB);
+		Cb_b_offset[i] = (int16) ( (0.587 / 0.331) * CB);
+
+		Cr_r_tab[i] = Cr_r_offset[i] + r_offset + 256;
+		Cr_g_tab[i] = Cr_g_offset[i] + g_offset + 256;
+		Cb_g_tab[i] = Cb_g_offset[i];
+		Cb_b_tab[i] = Cb_b_offset[i] + b_offset + 256;
 	}
 }
 
@@ -198,6 +213,62 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+YUVToRGBRow::ConvertFunc YUVToRGBRow::getConvertFunc(uint bytesPerPixel, bool halfChroma, bool alpha) {
+	ConvertFunc convertFunc = nullptr;
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) convertFunc = getConvertFuncNEON(bytesPerPixel, halfChroma, alpha);
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) convertFunc = getConvertFuncSSE2(bytesPerPixel, halfChroma, alpha);
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) convertFunc = getConvertFuncAVX2(bytesPerPixel, halfChroma, alpha);
+#endif
+
+	return convertFunc;
+}
+
+/**
+ * Convert an image with a YUVToRGBRow function. The chroma offsets of each
+ * row of chroma samples are looked up once, and then used for the
+ * 1 << uvShiftY rows of luminance it covers.
+ */
+static void convertYUVRows(YUVToRGBRow::ConvertFunc convertRow, byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, int uvShiftX, int uvShiftY) {
+	const int16 *Cr_r_tab = lookup->getOffsetTable();
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+
+	const YUVToRGBRowParams params(lookup->getFormat(), lookup->getScale() == YUVToRGBManager::kScaleITU);
+
+	const int uvWidth = yWidth >> uvShiftX;
+	Common::Array<int16> offsets;
+	offsets.resize(uvWidth * 3);
+	int16 *rOffsets = offsets.data();
+	int16 *gOffsets = rOffsets + uvWidth;
+	int16 *bOffsets = gOffsets + uvWidth;
+
+	for (int h = 0; h < yHeight; h += 1 << uvShiftY) {
+		for (int w = 0; w < uvWidth; w++) {
+			rOffsets[w] = Cr_r_tab[vSrc[w]];
+			gOffsets[w] = Cr_g_tab[vSrc[w]] + Cb_g_tab[uSrc[w]];
+			bOffsets[w] = Cb_b_tab[uSrc[w]];
+		}
+
+		for (int row = 0; row < (1 << uvShiftY); row++) {
+			convertRow(dstPtr, ySrc, aSrc, rOffsets, gOffsets, bOffsets, yWidth, params);
+			dstPtr += dstPitch;
+			ySrc += yPitch;
+			if (aSrc)
+				aSrc += yPitch;
+		}
+
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
 #define PUT_PIXEL(s, d) \
 	L = &clipTable[(s)]; \
 	*((PixelInt *)(d)) = ((L[cr_r] << r_shift) | (L[crb_g] << g_shift) | (L[cb_b] << b_shift) | a_mask)
@@ -246,6 +317,12 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRow::ConvertFunc convertRow = YUVToRGBRow::getConvertFunc(dst->format.bytesPerPixel, false, false);
+	if (convertRow) {
+		convertYUVRows(convertRow, (byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 0, 0);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -303,6 +380,12 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRow::ConvertFunc convertRow = YUVToRGBRow::getConvertFunc(dst->format.bytesPerPixel, true, false);
+	if (convertRow) {
+		convertYUVRows(convertRow, (byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 1, 0);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV422ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -364,6 +447,12 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRow::ConvertFunc convertRow = YUVToRGBRow::getConvertFunc(dst->format.bytesPerPixel, true, false);
+	if (convertRow) {
+		convertYUVRows(convertRow, (byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 1, 1);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -433,6 +522,12 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRow::ConvertFunc convertRow = YUVToRGBRow::getConvertFunc(dst->format.bytesPerPixel, true, true);
+	if (convertRow) {
+		convertYUVRows(convertRow, (byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, 1, 1);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -509,6 +604,54 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
+/**
+ * Convert a YUV410 image with a YUVToRGBRow function. The chroma is
+ * interpolated in the same way as in convertYUV410ToRGB().
+ */
+static void convertYUV410Rows(YUVToRGBRow::ConvertFunc convertRow, byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const int16 *Cr_r_tab = lookup->getOffsetTable();
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+
+	const YUVToRGBRowParams params(lookup->getFormat(), lookup->getScale() == YUVToRGBManager::kScaleITU);
+
+	Common::Array<int16> offsets;
+	offsets.resize(yWidth * 3);
+	int16 *rOffsets = offsets.data();
+	int16 *gOffsets = rOffsets + yWidth;
+	int16 *bOffsets = gOffsets + yWidth;
+
+	int quarterWidth = yWidth >> 2;
+
+	for (int y = 0; y < yHeight; y++) {
+		int16 *rOut = rOffsets, *gOut = gOffsets, *bOut = bOffsets;
+
+		for (int x = 0; x < quarterWidth; x++) {
+			int targetY = y >> 2;
+			int yDiff = y & 3;
+			int index = targetY * uvPitch + x;
+
+			READ_QUAD(uSrc, u);
+			READ_QUAD(vSrc, v);
+
+			for (int xDiff = 0; xDiff < 4; xDiff++) {
+				byte u, v;
+				DO_INTERPOLATION(u);
+				DO_INTERPOLATION(v);
+
+				*rOut++ = Cr_r_tab[v];
+				*gOut++ = Cr_g_tab[v] + Cb_g_tab[u];
+				*bOut++ = Cb_b_tab[u];
+			}
+		}
+
+		convertRow(dstPtr, ySrc, nullptr, rOffsets, gOffsets, bOffsets, yWidth, params);
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+}
+
 #undef READ_QUAD
 #undef DO_INTERPOLATION
 #undef DO_YUV410_PIXEL
@@ -523,6 +666,12 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRow::ConvertFunc convertRow = YUVToRGBRow::getConvertFunc(dst->format.bytesPerPixel, false, false);
+	if (convertRow) {
+		convertYUV410Rows(convertRow, (byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
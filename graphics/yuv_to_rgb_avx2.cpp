@@ -0,0 +1,128 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+class YUVToRGBRowImpl_AVX2 {
+	// Same as YUVToRGBRow::clip() on 16-bit values
+	static FORCEINLINE __m256i clip(__m256i value, bool itu) {
+		if (itu) {
+			__m256i s = _mm256_min_epi16(_mm256_max_epi16(value, _mm256_set1_epi16(16)), _mm256_set1_epi16(235));
+			s = _mm256_sub_epi16(s, _mm256_set1_epi16(16));
+			return _mm256_add_epi16(s, _mm256_mulhi_epu16(s, _mm256_set1_epi16((int16)YUVToRGBRow::kITUScale)));
+		}
+		return _mm256_min_epi16(_mm256_max_epi16(value, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+	}
+
+	// Unpacking works per 128-bit lane, so the subsampled offsets are
+	// duplicated in 128-bit registers before combining them
+	template<bool halfChroma>
+	static FORCEINLINE __m256i loadOffsets(const int16 *offsets, int x) {
+		if (halfChroma) {
+			__m128i o = _mm_loadu_si128((const __m128i *)(offsets + (x >> 1)));
+			return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(o, o)), _mm_unpackhi_epi16(o, o), 1);
+		}
+		return _mm256_loadu_si256((const __m256i *)(offsets + x));
+	}
+
+	static FORCEINLINE __m256i load8(const byte *src) {
+		return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)src));
+	}
+
+	// Combine the components of 8 pixels, given as 16-bit values in one half
+	// of the registers
+	static FORCEINLINE __m256i pack32(__m128i r, __m128i g, __m128i b, __m256i a, __m128i rShift, __m128i gShift, __m128i bShift) {
+		__m256i pixels = _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(r), rShift), _mm256_sll_epi32(_mm256_cvtepu16_epi32(g), gShift));
+		return _mm256_or_si256(_mm256_or_si256(pixels, _mm256_sll_epi32(_mm256_cvtepu16_epi32(b), bShift)), a);
+	}
+
+public:
+template<typename PixelInt, bool halfChroma, bool alpha>
+static void convert(byte *dst, const byte *ySrc, const byte *aSrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBRowParams &params) {
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i aLoss = _mm_cvtsi32_si128(params.aLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(params.aShift);
+	const bool itu = params.itu;
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		__m256i y = load8(ySrc + x);
+
+		__m256i r = _mm256_srl_epi16(clip(_mm256_add_epi16(y, loadOffsets<halfChroma>(rOffsets, x)), itu), rLoss);
+		__m256i g = _mm256_srl_epi16(clip(_mm256_add_epi16(y, loadOffsets<halfChroma>(gOffsets, x)), itu), gLoss);
+		__m256i b = _mm256_srl_epi16(clip(_mm256_add_epi16(y, loadOffsets<halfChroma>(bOffsets, x)), itu), bLoss);
+		__m256i a = _mm256_setzero_si256();
+		if (alpha)
+			a = _mm256_srl_epi16(load8(aSrc + x), aLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			__m256i pixels = _mm256_or_si256(_mm256_sll_epi16(r, rShift), _mm256_sll_epi16(g, gShift));
+			pixels = _mm256_or_si256(pixels, _mm256_sll_epi16(b, bShift));
+			if (alpha)
+				pixels = _mm256_or_si256(pixels, _mm256_sll_epi16(a, aShift));
+			else
+				pixels = _mm256_or_si256(pixels, _mm256_set1_epi16((int16)params.aMask));
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), pixels);
+		} else {
+			__m256i a0, a1;
+			if (alpha) {
+				a0 = _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(a)), aShift);
+				a1 = _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(a, 1)), aShift);
+			} else {
+				a0 = a1 = _mm256_set1_epi32(params.aMask);
+			}
+			__m256i p0 = pack32(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b), a0, rShift, gShift, bShift);
+			__m256i p1 = pack32(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(b, 1), a1, rShift, gShift, bShift);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4), p0);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4 + 32), p1);
+		}
+	}
+
+	YUVToRGBRow::convertGeneric<PixelInt, halfChroma, alpha>(dst, ySrc, aSrc, rOffsets, gOffsets, bOffsets, x, width, params);
+}
+
+}; // End of class YUVToRGBRowImpl_AVX2
+
+YUVToRGBRow::ConvertFunc YUVToRGBRow::getConvertFuncAVX2(uint bytesPerPixel, bool halfChroma, bool alpha) {
+	return selectConvertFunc<YUVToRGBRowImpl_AVX2>(bytesPerPixel, halfChroma, alpha);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "common/util.h"
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * The target format and luminance scale for YUVToRGBRow, unpacked for quick
+ * access.
+ */
+struct YUVToRGBRowParams {
+	bool itu;     ///< Luminance range [16, 235] instead of [0, 255]
+	byte rLoss, gLoss, bLoss, aLoss;
+	byte rShift, gShift, bShift, aShift;
+	uint32 aMask; ///< Alpha bits of an opaque pixel
+
+	YUVToRGBRowParams(const PixelFormat &format, bool isITU) :
+		itu(isITU),
+		rLoss(format.rLoss), gLoss(format.gLoss), bLoss(format.bLoss), aLoss(format.aLoss),
+		rShift(format.rShift), gShift(format.gShift), bShift(format.bShift), aShift(format.aShift),
+		aMask((0xFF >> format.aLoss) << format.aShift) {}
+};
+
+/**
+ * The per pixel part of the YUV to RGB conversion, which has SIMD
+ * implementations selected at runtime.
+ *
+ * The chroma values of a row are first turned into red, green and blue
+ * offsets to the luminance with the lookup tables, so that the kernels only
+ * have to add, clip and pack. The offsets are either given for every pixel,
+ * or for every other pixel for the subsampled formats.
+ *
+ * All implementations must produce output identical to the lookup table
+ * conversion in yuv_to_rgb.cpp.
+ */
+class YUVToRGBRow {
+public:
+	/**
+	 * Convert @p width pixels from @p ySrc, with the chroma offsets from
+	 * @p rOffsets, @p gOffsets and @p bOffsets, to @p dst. @p aSrc is only
+	 * used by the alpha variants.
+	 */
+	typedef void (*ConvertFunc)(byte *dst, const byte *ySrc, const byte *aSrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBRowParams &params);
+
+	/**
+	 * Return the fastest conversion function supported by the CPU, or
+	 * nullptr if there is none, in which case the lookup tables are faster.
+	 */
+	static ConvertFunc getConvertFunc(uint bytesPerPixel, bool halfChroma, bool alpha);
+
+#ifdef SCUMMVM_NEON
+	static ConvertFunc getConvertFuncNEON(uint bytesPerPixel, bool halfChroma, bool alpha);
+#endif
+#ifdef SCUMMVM_SSE2
+	static ConvertFunc getConvertFuncSSE2(uint bytesPerPixel, bool halfChroma, bool alpha);
+#endif
+#ifdef SCUMMVM_AVX2
+	static ConvertFunc getConvertFuncAVX2(uint bytesPerPixel, bool halfChroma, bool alpha);
+#endif
+
+	/**
+	 * Multiplier for the [16, 235] to [0, 255] scaling of the ITU range:
+	 * s * 255 / 219 == s + ((s * kITUScale) >> 16) for s in [0, 219].
+	 */
+	static const uint16 kITUScale = 10775;
+
+	/** Clip a luminance plus chroma offset to a component value. */
+	static inline uint clip(int value, bool itu) {
+		if (itu) {
+			value = CLIP(value, 16, 235) - 16;
+			return value * 255 / 219;
+		}
+		return CLIP(value, 0, 255);
+	}
+
+	/**
+	 * The reference implementation. The SIMD versions use it for the pixels
+	 * which don't fill a whole vector. For the subsampled formats, @p x must
+	 * be even.
+	 */
+	template<typename PixelInt, bool halfChroma, bool alpha>
+	static void convertGeneric(byte *dst, const byte *ySrc, const byte *aSrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int x, int width, const YUVToRGBRowParams &params) {
+		PixelInt *out = (PixelInt *)dst;
+		for (; x < width; x++) {
+			const int c = halfChroma ? (x >> 1) : x;
+			const int y = ySrc[x];
+			PixelInt pixel = (PixelInt)((clip(y + rOffsets[c], params.itu) >> params.rLoss) << params.rShift);
+			pixel |= (PixelInt)((clip(y + gOffsets[c], params.itu) >> params.gLoss) << params.gShift);
+			pixel |= (PixelInt)((clip(y + bOffsets[c], params.itu) >> params.bLoss) << params.bShift);
+			if (alpha)
+				pixel |= (PixelInt)((aSrc[x] >> params.aLoss) << params.aShift);
+			else
+				pixel |= (PixelInt)params.aMask;
+			out[x] = pixel;
+		}
+	}
+
+	/**
+	 * Helper for the SIMD implementations: returns the instantiation of
+	 * @p Impl::convert matching the given layout.
+	 */
+	template<class Impl>
+	static ConvertFunc selectConvertFunc(uint bytesPerPixel, bool halfChroma, bool alpha) {
+		if (bytesPerPixel == 2) {
+			if (halfChroma)
+				return alpha ? &Impl::template convert<uint16, true, true> : &Impl::template convert<uint16, true, false>;
+			else
+				return alpha ? &Impl::template convert<uint16, false, true> : &Impl::template convert<uint16, false, false>;
+		} else {
+			if (halfChroma)
+				return alpha ? &Impl::template convert<uint32, true, true> : &Impl::template convert<uint32, true, false>;
+			else
+				return alpha ? &Impl::template convert<uint32, false, true> : &Impl::template convert<uint32, false, false>;
+		}
+	}
+};
+
+} // End of namespace Graphics
+
+#endif
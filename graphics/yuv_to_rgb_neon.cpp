@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Graphics {
+
+class YUVToRGBRowImpl_NEON {
+	// Same as YUVToRGBRow::clip() on 16-bit values
+	static FORCEINLINE uint16x8_t clip(int16x8_t value, bool itu) {
+		if (itu) {
+			uint16x8_t s = vreinterpretq_u16_s16(vsubq_s16(vminq_s16(vmaxq_s16(value, vdupq_n_s16(16)), vdupq_n_s16(235)), vdupq_n_s16(16)));
+			const uint16x4_t scale = vdup_n_u16(YUVToRGBRow::kITUScale);
+			uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(s), scale), 16);
+			uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(s), scale), 16);
+			return vaddq_u16(s, vcombine_u16(lo, hi));
+		}
+		return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(value, vdupq_n_s16(0)), vdupq_n_s16(255)));
+	}
+
+	template<bool halfChroma>
+	static FORCEINLINE int16x8_t loadOffsets(const int16 *offsets, int x) {
+		if (halfChroma) {
+			int16x4_t o = vld1_s16(offsets + (x >> 1));
+			int16x4x2_t zipped = vzip_s16(o, o);
+			return vcombine_s16(zipped.val[0], zipped.val[1]);
+		}
+		return vld1q_s16(offsets + x);
+	}
+
+	// Combine the components of 4 pixels, given as 16-bit values
+	static FORCEINLINE uint32x4_t pack32(uint16x4_t r, uint16x4_t g, uint16x4_t b, uint32x4_t a, int32x4_t rShift, int32x4_t gShift, int32x4_t bShift) {
+		uint32x4_t pixels = vorrq_u32(vshlq_u32(vmovl_u16(r), rShift), vshlq_u32(vmovl_u16(g), gShift));
+		return vorrq_u32(vorrq_u32(pixels, vshlq_u32(vmovl_u16(b), bShift)), a);
+	}
+
+public:
+template<typename PixelInt, bool halfChroma, bool alpha>
+static void convert(byte *dst, const byte *ySrc, const byte *aSrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBRowParams &params) {
+	// Shifting by a negative amount shifts to the right
+	const int16x8_t rLoss = vdupq_n_s16(-params.rLoss);
+	const int16x8_t gLoss = vdupq_n_s16(-params.gLoss);
+	const int16x8_t bLoss = vdupq_n_s16(-params.bLoss);
+	const int16x8_t aLoss = vdupq_n_s16(-params.aLoss);
+	const bool itu = params.itu;
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + x)));
+
+		uint16x8_t r = vshlq_u16(clip(vaddq_s16(y, loadOffsets<halfChroma>(rOffsets, x)), itu), rLoss);
+		uint16x8_t g = vshlq_u16(clip(vaddq_s16(y, loadOffsets<halfChroma>(gOffsets, x)), itu), gLoss);
+		uint16x8_t b = vshlq_u16(clip(vaddq_s16(y, loadOffsets<halfChroma>(bOffsets, x)), itu), bLoss);
+		uint16x8_t a = vdupq_n_u16(0);
+		if (alpha)
+			a = vshlq_u16(vmovl_u8(vld1_u8(aSrc + x)), aLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			uint16x8_t pixels = vorrq_u16(vshlq_u16(r, vdupq_n_s16(params.rShift)), vshlq_u16(g, vdupq_n_s16(params.gShift)));
+			pixels = vorrq_u16(pixels, vshlq_u16(b, vdupq_n_s16(params.bShift)));
+			if (alpha)
+				pixels = vorrq_u16(pixels, vshlq_u16(a, vdupq_n_s16(params.aShift)));
+			else
+				pixels = vorrq_u16(pixels, vdupq_n_u16((uint16)params.aMask));
+			vst1q_u16((uint16 *)(dst + x * 2), pixels);
+		} else {
+			const int32x4_t rShift = vdupq_n_s32(params.rShift);
+			const int32x4_t gShift = vdupq_n_s32(params.gShift);
+			const int32x4_t bShift = vdupq_n_s32(params.bShift);
+			uint32x4_t a0, a1;
+			if (alpha) {
+				const int32x4_t aShift = vdupq_n_s32(params.aShift);
+				a0 = vshlq_u32(vmovl_u16(vget_low_u16(a)), aShift);
+				a1 = vshlq_u32(vmovl_u16(vget_high_u16(a)), aShift);
+			} else {
+				a0 = a1 = vdupq_n_u32(params.aMask);
+			}
+			vst1q_u32((uint32 *)(dst + x * 4), pack32(vget_low_u16(r), vget_low_u16(g), vget_low_u16(b), a0, rShift, gShift, bShift));
+			vst1q_u32((uint32 *)(dst + x * 4 + 16), pack32(vget_high_u16(r), vget_high_u16(g), vget_high_u16(b), a1, rShift, gShift, bShift));
+		}
+	}
+
+	YUVToRGBRow::convertGeneric<PixelInt, halfChroma, alpha>(dst, ySrc, aSrc, rOffsets, gOffsets, bOffsets, x, width, params);
+}
+
+}; // End of class YUVToRGBRowImpl_NEON
+
+YUVToRGBRow::ConvertFunc YUVToRGBRow::getConvertFuncNEON(uint bytesPerPixel, bool halfChroma, bool alpha) {
+	return selectConvertFunc<YUVToRGBRowImpl_NEON>(bytesPerPixel, halfChroma, alpha);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,126 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Graphics {
+
+class YUVToRGBRowImpl_SSE2 {
+	// Same as YUVToRGBRow::clip() on 16-bit values
+	static FORCEINLINE __m128i clip(__m128i value, bool itu) {
+		if (itu) {
+			__m128i s = _mm_min_epi16(_mm_max_epi16(value, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+			s = _mm_sub_epi16(s, _mm_set1_epi16(16));
+			return _mm_add_epi16(s, _mm_mulhi_epu16(s, _mm_set1_epi16((int16)YUVToRGBRow::kITUScale)));
+		}
+		return _mm_min_epi16(_mm_max_epi16(value, _mm_setzero_si128()), _mm_set1_epi16(255));
+	}
+
+	template<bool halfChroma>
+	static FORCEINLINE __m128i loadOffsets(const int16 *offsets, int x) {
+		if (halfChroma) {
+			__m128i o = _mm_loadl_epi64((const __m128i *)(offsets + (x >> 1)));
+			return _mm_unpacklo_epi16(o, o);
+		}
+		return _mm_loadu_si128((const __m128i *)(offsets + x));
+	}
+
+	// Combine the components of 4 pixels, given as 32-bit values
+	static FORCEINLINE __m128i pack32(__m128i r, __m128i g, __m128i b, __m128i a, __m128i rShift, __m128i gShift, __m128i bShift) {
+		__m128i pixels = _mm_or_si128(_mm_sll_epi32(r, rShift), _mm_sll_epi32(g, gShift));
+		return _mm_or_si128(_mm_or_si128(pixels, _mm_sll_epi32(b, bShift)), a);
+	}
+
+public:
+template<typename PixelInt, bool halfChroma, bool alpha>
+static void convert(byte *dst, const byte *ySrc, const byte *aSrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBRowParams &params) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i aLoss = _mm_cvtsi32_si128(params.aLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(params.aShift);
+	const bool itu = params.itu;
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		__m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), zero);
+
+		__m128i r = _mm_srl_epi16(clip(_mm_add_epi16(y, loadOffsets<halfChroma>(rOffsets, x)), itu), rLoss);
+		__m128i g = _mm_srl_epi16(clip(_mm_add_epi16(y, loadOffsets<halfChroma>(gOffsets, x)), itu), gLoss);
+		__m128i b = _mm_srl_epi16(clip(_mm_add_epi16(y, loadOffsets<halfChroma>(bOffsets, x)), itu), bLoss);
+		__m128i a = zero;
+		if (alpha)
+			a = _mm_srl_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(aSrc + x)), zero), aLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			__m128i pixels = _mm_or_si128(_mm_sll_epi16(r, rShift), _mm_sll_epi16(g, gShift));
+			pixels = _mm_or_si128(pixels, _mm_sll_epi16(b, bShift));
+			if (alpha)
+				pixels = _mm_or_si128(pixels, _mm_sll_epi16(a, aShift));
+			else
+				pixels = _mm_or_si128(pixels, _mm_set1_epi16((int16)params.aMask));
+			_mm_storeu_si128((__m128i *)(dst + x * 2), pixels);
+		} else {
+			__m128i a0, a1;
+			if (alpha) {
+				a0 = _mm_sll_epi32(_mm_unpacklo_epi16(a, zero), aShift);
+				a1 = _mm_sll_epi32(_mm_unpackhi_epi16(a, zero), aShift);
+			} else {
+				a0 = a1 = _mm_set1_epi32(params.aMask);
+			}
+			__m128i p0 = pack32(_mm_unpacklo_epi16(r, zero), _mm_unpacklo_epi16(g, zero), _mm_unpacklo_epi16(b, zero), a0, rShift, gShift, bShift);
+			__m128i p1 = pack32(_mm_unpackhi_epi16(r, zero), _mm_unpackhi_epi16(g, zero), _mm_unpackhi_epi16(b, zero), a1, rShift, gShift, bShift);
+			_mm_storeu_si128((__m128i *)(dst + x * 4), p0);
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), p1);
+		}
+	}
+
+	YUVToRGBRow::convertGeneric<PixelInt, halfChroma, alpha>(dst, ySrc, aSrc, rOffsets, gOffsets, bOffsets, x, width, params);
+}
+
+}; // End of class YUVToRGBRowImpl_SSE2
+
+YUVToRGBRow::ConvertFunc YUVToRGBRow::getConvertFuncSSE2(uint bytesPerPixel, bool halfChroma, bool alpha) {
+	return selectConvertFunc<YUVToRGBRowImpl_SSE2>(bytesPerPixel, halfChroma, alpha);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
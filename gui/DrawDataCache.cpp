@@ -0,0 +1,188 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gui/DrawDataCache.h"
+
+namespace GUI {
+
+void DrawDataCache::clear() {
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		for (uint j = 0; j < i->_value.size(); j++)
+			i->_value[j].free();
+	}
+	_entries.clear();
+	_drawsOutside.clear();
+	_pendingBackground.free();
+	_pixels = 0;
+}
+
+bool DrawDataCache::drawSteps(Graphics::VectorRenderer *renderer, DrawData type, const Common::List<Graphics::DrawStep> &steps,
+                              const Common::Rect &area, const Common::Rect &rect, const Common::Rect &clip, uint32 dynamic) {
+	Graphics::ManagedSurface &surface = *renderer->getActiveSurface();
+
+	Common::Rect checkRect = rect;
+	checkRect.grow(kCheckMargin);
+	checkRect.clip(surface.w, surface.h);
+	if (!clip.isEmpty())
+		checkRect.clip(clip);
+
+	Key key;
+	key.type = type;
+	key.dynamic = dynamic;
+	key.width = area.width();
+	key.height = area.height();
+	key.rect = rect;
+	key.rect.translate(-area.left, -area.top);
+	key.checkRect = checkRect;
+	key.checkRect.translate(-area.left, -area.top);
+	key.state = renderer->getInheritedState();
+
+	Common::List<Graphics::DrawStep>::const_iterator step;
+	if (blit(surface, key, rect, checkRect)) {
+		for (step = steps.begin(); step != steps.end(); ++step) {
+			renderer->applyStepState(area, clip, *step, dynamic);
+		}
+		return true;
+	}
+
+	for (step = steps.begin(); step != steps.end(); ++step) {
+		renderer->drawStep(area, clip, *step, dynamic);
+	}
+	store(surface);
+	return false;
+}
+
+bool DrawDataCache::blit(Graphics::ManagedSurface &surface, const Key &key, const Common::Rect &rect, const Common::Rect &checkRect) {
+	_pendingBackground.free();
+
+	// Large items such as dialog backgrounds would push out all the others
+	if ((uint)rect.width() * rect.height() * 2 > _maxPixels / 4)
+		return false;
+
+	if (_drawsOutside.contains(key))
+		return false;
+
+	const Graphics::Surface background = surface.rawSurface().getSubArea(rect);
+	const int rowSize = rect.width() * background.format.bytesPerPixel;
+
+	EntryMap::iterator i = _entries.find(key);
+	if (i != _entries.end()) {
+		for (uint j = 0; j < i->_value.size(); j++) {
+			Entry &entry = i->_value[j];
+			int y = 0;
+			while (y < rect.height() && !memcmp(entry.background.getBasePtr(0, y), background.getBasePtr(0, y), rowSize))
+				y++;
+
+			if (y == rect.height()) {
+				surface.copyRectToSurface(entry.rendering, rect.left, rect.top, Common::Rect(rect.width(), rect.height()));
+				entry.lastUse = ++_useCount;
+				return true;
+			}
+		}
+	}
+
+	_pendingKey = key;
+	_pendingRect = rect;
+	_pendingCheckRect = checkRect;
+	_pendingBackground.copyFrom(surface.rawSurface().getSubArea(checkRect));
+	return false;
+}
+
+bool DrawDataCache::drewOutside(Graphics::ManagedSurface &surface) const {
+	const Graphics::Surface drawn = surface.rawSurface().getSubArea(_pendingCheckRect);
+	const int bpp = drawn.format.bytesPerPixel;
+	const int left = _pendingRect.left - _pendingCheckRect.left;
+	const int right = _pendingRect.right - _pendingCheckRect.left;
+
+	for (int y = 0; y < drawn.h; y++) {
+		const byte *before = (const byte *)_pendingBackground.getBasePtr(0, y);
+		const byte *after = (const byte *)drawn.getBasePtr(0, y);
+		const int row = _pendingCheckRect.top + y;
+
+		if (row < _pendingRect.top || row >= _pendingRect.bottom) {
+			if (memcmp(before, after, drawn.w * bpp))
+				return true;
+		} else if (memcmp(before, after, left * bpp) ||
+		           memcmp(before + right * bpp, after + right * bpp, (drawn.w - right) * bpp)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void DrawDataCache::store(Graphics::ManagedSurface &surface) {
+	if (!_pendingBackground.getPixels())
+		return;
+
+	// The rendering wouldn't hold everything the steps drew
+	if (drewOutside(surface)) {
+		_drawsOutside[_pendingKey] = true;
+		_pendingBackground.free();
+		return;
+	}
+
+	Common::Rect rect = _pendingRect;
+	rect.translate(-_pendingCheckRect.left, -_pendingCheckRect.top);
+
+	Entry entry;
+	entry.background.copyFrom(_pendingBackground.getSubArea(rect));
+	entry.rendering.copyFrom(surface.rawSurface().getSubArea(_pendingRect));
+	entry.lastUse = ++_useCount;
+	_pendingBackground.free();
+
+	// Drop the least recently used renderings to make room
+	while (_pixels + entry.pixels() > _maxPixels && !_entries.empty()) {
+		EntryMap::iterator oldestList = _entries.begin();
+		uint oldest = 0;
+		for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+			for (uint j = 0; j < i->_value.size(); j++) {
+				if (i->_value[j].lastUse < oldestList->_value[oldest].lastUse) {
+					oldestList = i;
+					oldest = j;
+				}
+			}
+		}
+
+		_pixels -= oldestList->_value[oldest].pixels();
+		oldestList->_value[oldest].free();
+		oldestList->_value.remove_at(oldest);
+		if (oldestList->_value.empty())
+			_entries.erase(oldestList);
+	}
+
+	EntryList &list = _entries[_pendingKey];
+	if (list.size() == kMaxBackgrounds) {
+		uint oldest = 0;
+		for (uint j = 1; j < list.size(); j++) {
+			if (list[j].lastUse < list[oldest].lastUse)
+				oldest = j;
+		}
+		_pixels -= list[oldest].pixels();
+		list[oldest].free();
+		list.remove_at(oldest);
+	}
+
+	list.push_back(entry);
+	_pixels += entry.pixels();
+}
+
+} // End of namespace GUI
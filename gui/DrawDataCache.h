@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GUI_DRAWDATA_CACHE_H
+#define GUI_DRAWDATA_CACHE_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/rect.h"
+
+#include "graphics/surface.h"
+#include "graphics/VectorRenderer.h"
+
+#include "gui/ThemeEngine.h"
+
+namespace GUI {
+
+/**
+ * Renderings of DrawData items, blitted instead of drawing their steps again.
+ * The steps draw the same pixels wherever the area of the item is, so a
+ * rendering is reused for an item drawn with the same size, dynamic data and
+ * inherited renderer state over the same background. The background is
+ * compared with a copy of the one the rendering was drawn over.
+ *
+ * Only the rect marked as dirty for the item is cached. Items whose steps
+ * change pixels next to that rect are drawn every time.
+ */
+class DrawDataCache {
+public:
+	DrawDataCache() : _pixels(0), _maxPixels(0), _useCount(0) {}
+	~DrawDataCache() { clear(); }
+
+	/** Drops all the renderings. */
+	void clear();
+
+	/** Drops all the renderings, and keeps at most @p maxPixels pixels from now on. */
+	void reset(uint maxPixels) {
+		clear();
+		_maxPixels = maxPixels;
+	}
+
+	/**
+	 * Draws the steps of an item in @p area with VectorRenderer::drawStep(),
+	 * or blits their rendering to @p rect if there is one.
+	 *
+	 * @param rect The rect marked as dirty for the item, inside @p clip
+	 * @param clip The clipping rect the steps are drawn with
+	 * @return Whether a rendering was blitted
+	 */
+	bool drawSteps(Graphics::VectorRenderer *renderer, DrawData type, const Common::List<Graphics::DrawStep> &steps,
+	               const Common::Rect &area, const Common::Rect &rect, const Common::Rect &clip, uint32 dynamic);
+
+private:
+	/** How far around the cached rect the steps must not change anything. */
+	static const int kCheckMargin = 16;
+
+	/** Number of renderings of an item over different backgrounds. */
+	static const uint kMaxBackgrounds = 8;
+
+	struct Key {
+		DrawData type;
+		uint32 dynamic;
+		int16 width, height;    ///< The size of the area of the item
+		Common::Rect rect;      ///< The cached rect, relative to the area
+		Common::Rect checkRect; ///< The rect checked for changes outside of the cached one, relative to the area
+		Graphics::VectorRenderer::InheritedState state;
+
+		bool operator==(const Key &key) const {
+			return type == key.type && dynamic == key.dynamic && width == key.width && height == key.height &&
+				rect == key.rect && checkRect == key.checkRect && state == key.state;
+		}
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const {
+			return key.type ^ (key.dynamic * 31) ^ (key.width << 8) ^ (key.height << 20) ^ key.state.fgColor;
+		}
+	};
+
+	struct Entry {
+		Graphics::Surface background, rendering;
+		uint32 lastUse;
+
+		uint pixels() const { return background.w * background.h * 2; }
+		void free() {
+			background.free();
+			rendering.free();
+		}
+	};
+
+	/** The renderings of an item over different backgrounds, e.g. at different places. */
+	typedef Common::Array<Entry> EntryList;
+	typedef Common::HashMap<Key, EntryList, KeyHash> EntryMap;
+	typedef Common::HashMap<Key, bool, KeyHash> KeySet;
+
+	/**
+	 * Blits the rendering of an item to @p rect of @p surface, if there is one
+	 * for the background in @p rect. Otherwise, copies the background in
+	 * @p checkRect so that store() can check and add the rendering once the
+	 * item is drawn.
+	 */
+	bool blit(Graphics::ManagedSurface &surface, const Key &key, const Common::Rect &rect, const Common::Rect &checkRect);
+
+	/** Adds the rendering of the item the last call to blit() didn't find. */
+	void store(Graphics::ManagedSurface &surface);
+
+	/** Whether the steps changed a pixel of the pending check rect outside of the pending rect. */
+	bool drewOutside(Graphics::ManagedSurface &surface) const;
+
+	EntryMap _entries;
+	KeySet _drawsOutside;     ///< The items which changed pixels outside of their rect
+	uint _pixels, _maxPixels; ///< Counting the backgrounds and the renderings
+	uint32 _useCount;
+
+	// The item being drawn after a failed lookup
+	Key _pendingKey;
+	Common::Rect _pendingRect, _pendingCheckRect;
+	Graphics::Surface _pendingBackground;
+};
+
+} // End of namespace GUI
+
+#endif
@@ -41,6 +41,7 @@
 #include "image/png.h"
 
 #include "gui/widget.h"
+#include "gui/DrawDataCache.h"
 #include "gui/ThemeEngine.h"
 #include "gui/ThemeEval.h"
 #include "gui/ThemeParser.h"
@@ -191,6 +192,8 @@ ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
 	_cursor(nullptr), _scaleFactor(1.0f) {
 
+	_drawDataCache = new DrawDataCache();
+
 	_baseWidth = 640;	// Default sane values
 	_baseHeight = 480;
 
@@ -259,6 +262,7 @@ ThemeEngine::~ThemeEngine() {
 	delete _parser;
 	delete _themeEval;
 	delete[] _cursor;
+	delete _drawDataCache;
 }
 
 
@@ -464,6 +468,10 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	_vectorRenderer = Graphics::createRenderer(mode);
 	_vectorRenderer->setSurface(&_screen);
 
+	// Renderings of as many pixels as the screen has, for the background and
+	// the result each
+	_drawDataCache->reset(width * height * 2);
+
 	// Since we reinitialized our screen surfaces we know nothing has been
 	// drawn so far. Sometimes we still end up with dirty screen bits in the
 	// list. Clearing it avoids invalid overlay writes when the backend
@@ -791,6 +799,7 @@ void ThemeEngine::unloadTheme() {
 		delete _widgets[i];
 		_widgets[i] = nullptr;
 	}
+	_drawDataCache->clear();
 
 	for (int i = 0; i < kTextDataMAX; ++i) {
 		// Don't unload the language specific extra font here or it will be lost after a refresh() call.
@@ -933,6 +942,13 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		extendedRect.bottom += drawData->_shadowOffset - drawData->_backgroundOffset;
 	}
 
+	// The shadows of rounded squares also have a border of 2px on the left,
+	// and reach one more row at the bottom
+	if (drawData->_shadowOffset) {
+		extendedRect.left = MIN<int16>(extendedRect.left, area.left - 2);
+		extendedRect.bottom++;
+	}
+
 	if (!_clip.isEmpty()) {
 		extendedRect.clip(_clip);
 	}
@@ -946,10 +962,7 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		restoreBackground(extendedRect);
 
 	if (drawData->_layer == _layerToDraw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
-			_vectorRenderer->drawStep(area, _clip, *step, dynamic);
-		}
+		_drawDataCache->drawSteps(_vectorRenderer, type, drawData->_steps, area, extendedRect, _clip, dynamic);
 
 		addDirtyRect(extendedRect);
 	}
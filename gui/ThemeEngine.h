@@ -48,6 +48,7 @@ class VectorRenderer;
 namespace GUI {
 
 struct WidgetDrawData;
+class DrawDataCache;
 struct TextDrawData;
 class Dialog;
 class GuiObject;
@@ -789,6 +790,9 @@ protected:
 	 */
 	WidgetDrawData *_widgets[kDrawDataMAX];
 
+	/** Renderings of the DrawData elements drawn before. */
+	DrawDataCache *_drawDataCache;
+
 	/** Array of all the text fonts that can be drawn. */
 	TextDrawData *_texts[kTextDataMAX];
 
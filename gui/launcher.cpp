@@ -158,9 +158,11 @@ bool LauncherFilterMatcher(void *boss, int idx, const Common::U32String &item, c
 			}
 		}
 
+		// Items without a game domain match like games without the key
+		static const Common::String noValue;
 		LauncherDialog *launcher = (LauncherDialog *)(boss);
-		Common::String data = launcher->getGameConfig(idx, key);
-		data.toLowercase();
+		const Common::StringArray &values = launcher->getFilterValues(key);
+		const Common::String &data = (idx >= 0 && (uint)idx < values.size()) ? values[idx] : noValue;
 
 		if (token8[pos] == ':') {
 			result = data.contains(filter);
@@ -445,6 +447,18 @@ Common::String LauncherDialog::getGameConfig(int item, Common::String key) {
 	return "";
 }
 
+const Common::StringArray &LauncherDialog::getFilterValues(const Common::String &key) {
+	Common::StringArray &values = _filterValues[key];
+	if (values.size() != _domains.size()) {
+		values.resize(_domains.size());
+		for (uint i = 0; i < _domains.size(); ++i) {
+			values[i] = getGameConfig(i, key);
+			values[i].toLowercase();
+		}
+	}
+	return values;
+}
+
 void LauncherDialog::removeGame(int item) {
 	MessageDialog alert(_("Do you really want to remove this game configuration?"), _("Yes"), _("No"));
 
@@ -1135,6 +1149,7 @@ void LauncherSimple::updateListing(int selPos) {
 
 	// Retrieve a list of all games defined in the config file
 	_domains.clear();
+	_filterValues.clear();
 	const Common::ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
 	bool scanEntries = numEntries == -1 ? true : ((int)domains.size() <= numEntries);
 
@@ -1573,12 +1588,16 @@ void LauncherGrid::handleCommand(CommandSender *sender, uint32 cmd, uint32 data)
 void LauncherGrid::updateListing(int selPos) {
 	// Retrieve a list of all games defined in the config file
 	_domains.clear();
+	_filterValues.clear();
 	const Common::ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
+	int numEntries = ConfMan.getInt("gui_list_max_scan_entries");
+	bool scanEntries = numEntries == -1 ? true : ((int)domains.size() <= numEntries);
 
 	// Turn it into a sorted list of entries
 	Common::Array<LauncherEntry> domainList = generateEntries(domains);
 
 	Common::Array<GridItemInfo> gridList;
+	gridList.reserve(domainList.size());
 
 	int k = 0;
 	for (Common::Array<LauncherEntry>::const_iterator iter = domainList.begin(); iter != domainList.end(); ++iter) {
@@ -1588,12 +1607,13 @@ void LauncherGrid::updateListing(int selPos) {
 		Common::String platform;
 		Common::String extra;
 		Common::String path;
-		bool valid_path = false;
+		bool valid_path = true;
 		iter->domain->tryGetVal("engineid", engineid);
 		iter->domain->tryGetVal("language", language);
 		iter->domain->tryGetVal("platform", platform);
 		iter->domain->tryGetVal("extra", extra);
-		valid_path = (!iter->domain->tryGetVal("path", path) || !Common::FSNode(Common::Path::fromConfig(path)).isDirectory()) ? false : true;
+		if (scanEntries)
+			valid_path = (!iter->domain->tryGetVal("path", path) || !Common::FSNode(Common::Path::fromConfig(path)).isDirectory()) ? false : true;
 		gridList.push_back(GridItemInfo(k++, engineid, gameid, iter->description, iter->title, extra, Common::parseLanguage(language), Common::parsePlatform(platform), valid_path));
 		_domains.push_back(iter->key);
 	}
@@ -1653,6 +1673,8 @@ void LauncherGrid::build() {
 
 	// Add list with game titles
 	_grid = new GridWidget(this, "LauncherGrid.IconArea");
+	// The grid loads the thumbnails while idle
+	setTickleWidget(_grid);
 	// Populate the list
 	updateListing();
 
@@ -122,6 +122,11 @@ public:
 	void handleOtherEvent(const Common::Event &evt) override;
 	bool doGameDetection(const Common::Path &path);
 	Common::String getGameConfig(int item, Common::String key);
+	/**
+	 * Return the values of a config key for all the listed games, in lower
+	 * case. These are looked up once per listing, for the search filter.
+	 */
+	const Common::StringArray &getFilterValues(const Common::String &key);
 protected:
 	EditTextWidget  *_searchWidget;
 #ifndef DISABLE_FANCY_THEMES
@@ -137,6 +142,7 @@ protected:
 	ButtonWidget	*_loadButton;
 	Widget			*_editButton;
 	Common::StringArray		_domains;
+	Common::HashMap<Common::String, Common::StringArray>	_filterValues;
 	BrowserDialog	*_browser;
 	SaveLoadChooser	*_loadDialog;
 	PopUpWidget		*_grpChooserPopup;
@@ -53,6 +53,14 @@ void GridItemWidget::updateThumb() {
 		_thumbGfx.copyFrom(*gfx);
 }
 
+void GridItemWidget::checkThumb() {
+	// The thumbnail may have been loaded after the entry was assigned
+	if (_activeEntry && _thumbGfx.empty() && _grid->filenameToSurface(_activeEntry->thumbPath)) {
+		updateThumb();
+		markAsDirty();
+	}
+}
+
 void GridItemWidget::update() {
 	if (_activeEntry) {
 		updateThumb();
@@ -394,6 +402,11 @@ Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int re
 
 #pragma mark -
 
+enum {
+	kThumbnailLoadTime = 10, ///< Milliseconds per frame spent loading thumbnails
+	kMinCachedThumbnails = 256
+};
+
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 	: ContainerWidget(boss, name), CommandSender(boss) {
 
@@ -439,6 +452,10 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 
 	_selectedEntry = nullptr;
 	_isGridInvalid = true;
+
+	_thumbnailUseCount = 0;
+	_thumbnailsPending = false;
+	setFlags(getFlags() | WIDGET_WANT_TICKLE);
 }
 
 GridWidget::~GridWidget() {
@@ -446,6 +463,7 @@ GridWidget::~GridWidget() {
 	unloadSurfaces(_languageIcons);
 	unloadSurfaces(_extraIcons);
 	unloadSurfaces(_loadedSurfaces);
+	_thumbnailLastUse.clear();
 	delete _disabledIconOverlay;
 	_gridItems.clear();
 	_dataEntryList.clear();
@@ -465,7 +483,7 @@ void GridWidget::unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurfac
 const Graphics::ManagedSurface *GridWidget::filenameToSurface(const Common::String &name) {
 	if (name.empty())
 		return nullptr;
-	return _loadedSurfaces[name];
+	return _loadedSurfaces.getValOrDefault(name, nullptr);
 }
 
 const Graphics::ManagedSurface *GridWidget::languageToSurface(Common::Language languageCode) {
@@ -578,18 +596,14 @@ void GridWidget::sortGroups() {
 		// as substrings, ignoring case.
 
 		Common::U32StringTokenizer tok(_filter);
-		Common::U32String tmp;
-		int n = 0;
 
 		_sortedEntryList.clear();
 
-		for (GridItemInfo *i = _dataEntryList.begin(); i != _dataEntryList.end(); ++i, ++n) {
-			tmp = i->title;
-			tmp.toLowercase();
+		for (GridItemInfo *i = _dataEntryList.begin(); i != _dataEntryList.end(); ++i) {
 			bool matches = true;
 			tok.reset();
 			while (!tok.empty()) {
-				if (!tmp.contains(tok.nextToken())) {
+				if (!i->lowerTitle.contains(tok.nextToken())) {
 					matches = false;
 					break;
 				}
@@ -688,12 +702,21 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 void GridWidget::reloadThumbnails() {
 	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
 	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+	const uint32 startTime = g_system->getMillis();
+	_thumbnailsPending = false;
 	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
 		GridItemInfo *entry = *iter;
 		if (entry->thumbPath.empty())
 			continue;
 
+		_thumbnailLastUse[entry->thumbPath] = ++_thumbnailUseCount;
 		if (!_loadedSurfaces.contains(entry->thumbPath)) {
+			// Leave the rest for handleTickle() if this takes too long
+			if (g_system->getMillis() - startTime >= kThumbnailLoadTime) {
+				_thumbnailsPending = true;
+				continue;
+			}
+
 			_loadedSurfaces[entry->thumbPath] = nullptr;
 			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
 			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
@@ -701,7 +724,7 @@ void GridWidget::reloadThumbnails() {
 				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
 				if (!_loadedSurfaces.contains(path)) {
 					surf = loadSurfaceFromFile(path);
-				} else {
+				} else if (_loadedSurfaces[path]) {
 					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
 					_loadedSurfaces[entry->thumbPath] = new Graphics::ManagedSurface(*scSurf);
 				}
@@ -713,6 +736,7 @@ void GridWidget::reloadThumbnails() {
 
 				if (path != entry->thumbPath) {
 					_loadedSurfaces[path] = new Graphics::ManagedSurface(*scSurf);
+					_thumbnailLastUse[path] = _thumbnailUseCount;
 				}
 
 				if (surf != scSurf) {
@@ -722,6 +746,33 @@ void GridWidget::reloadThumbnails() {
 			}
 		}
 	}
+
+	unloadOldThumbnails();
+}
+
+void GridWidget::unloadOldThumbnails() {
+	const uint maxThumbnails = MAX<uint>(kMinCachedThumbnails, _visibleEntryList.size() * 4);
+	if (_thumbnailLastUse.size() <= maxThumbnails)
+		return;
+
+	// Keep the 3/4 shown most recently, which always include the visible ones
+	Common::Array<uint32> uses;
+	uses.reserve(_thumbnailLastUse.size());
+	for (Common::HashMap<Common::String, uint32>::iterator i = _thumbnailLastUse.begin(); i != _thumbnailLastUse.end(); ++i)
+		uses.push_back(i->_value);
+	Common::sort(uses.begin(), uses.end());
+	const uint32 oldest = uses[uses.size() - maxThumbnails * 3 / 4];
+
+	Common::StringArray unused;
+	for (Common::HashMap<Common::String, uint32>::iterator i = _thumbnailLastUse.begin(); i != _thumbnailLastUse.end(); ++i) {
+		if (i->_value < oldest)
+			unused.push_back(i->_key);
+	}
+	for (uint i = 0; i < unused.size(); ++i) {
+		delete _loadedSurfaces.getValOrDefault(unused[i], nullptr);
+		_loadedSurfaces.erase(unused[i]);
+		_thumbnailLastUse.erase(unused[i]);
+	}
 }
 
 void GridWidget::loadFlagIcons() {
@@ -936,6 +987,15 @@ void GridWidget::handleCommand(CommandSender *sender, uint32 cmd, uint32 data) {
 	}
 }
 
+void GridWidget::handleTickle() {
+	if (!_thumbnailsPending)
+		return;
+
+	reloadThumbnails();
+	for (uint i = 0; i < _gridItems.size() && i < _visibleEntryList.size(); ++i)
+		_gridItems[i]->checkThumb();
+}
+
 void GridWidget::calcInnerHeight() {
 	int row = 0;
 	int col = 0;
@@ -991,15 +1051,17 @@ void GridWidget::calcEntrySizes() {
 			entry->h = _gridHeaderHeight;
 			entry->w = _gridHeaderWidth;
 		} else {
-			int titleRows;
-			if (_isTitlesVisible) {
-				Common::Array<Common::U32String> titleLines;
-				g_gui.getFont().wordWrapText(entry->title, _gridItemWidth, titleLines);
-				titleRows = MIN(2U, titleLines.size());
-			} else {
-				titleRows = 0;
+			// Wrapping the titles is slow, so it is only done again on layout changes
+			if (entry->titleRows < 0) {
+				if (_isTitlesVisible) {
+					Common::Array<Common::U32String> titleLines;
+					g_gui.getFont().wordWrapText(entry->title, _gridItemWidth, titleLines);
+					entry->titleRows = MIN(2U, titleLines.size());
+				} else {
+					entry->titleRows = 0;
+				}
 			}
-			entry->h = _thumbnailHeight + titleRows * kLineHeight;
+			entry->h = _thumbnailHeight + entry->titleRows * kLineHeight;
 			entry->w = _gridItemWidth;
 		}
 	}
@@ -1051,6 +1113,7 @@ void GridWidget::reflowLayout() {
 		unloadSurfaces(_platformIcons);
 		unloadSurfaces(_languageIcons);
 		unloadSurfaces(_loadedSurfaces);
+		_thumbnailLastUse.clear();
 		if (_disabledIconOverlay)
 			_disabledIconOverlay->free();
 		reloadThumbnails();
@@ -1073,6 +1136,9 @@ void GridWidget::reflowLayout() {
 
 	_gridXSpacing = MAX(((_scrollWindowWidth - _scrollBarWidth - (2 * _scrollWindowPaddingX)) - (_itemsPerRow * _gridItemWidth)) / (_itemsPerRow + 1), _minGridXSpacing);
 
+	// The font or the item width may have changed
+	for (uint i = 0; i < _dataEntryList.size(); ++i)
+		_dataEntryList[i].titleRows = -1;
 	calcEntrySizes();
 	calcInnerHeight();
 
@@ -56,6 +56,10 @@ struct GridItemInfo {
 	Common::String		description;
 	Common::String		extra;
 	Common::String 		thumbPath;
+	// The title in lower case, which the search filter is matched against
+	Common::U32String	lowerTitle;
+	// Number of lines of the title, -1 until it is computed for the current layout
+	int					titleRows;
 	// Generic attribute value, may be any piece of metadata
 	Common::String		attribute;
 	Common::Language	language;
@@ -65,12 +69,15 @@ struct GridItemInfo {
 
 	GridItemInfo(int id, const Common::String &eid, const Common::String &gid, const Common::String &t,
 		const Common::String &d, const Common::String &e, Common::Language l, Common::Platform p, bool v)
-		: entryID(id), gameid(gid), engineid(eid), title(t), description(d), extra(e), language(l), platform(p), validEntry(v), isHeader(false) {
+		: entryID(id), gameid(gid), engineid(eid), title(t), description(d), extra(e), language(l), platform(p), validEntry(v), isHeader(false),
+		titleRows(-1) {
 		thumbPath = Common::String::format("icons/%s-%s.png", engineid.c_str(), gameid.c_str());
+		lowerTitle = Common::U32String(title);
+		lowerTitle.toLowercase();
 	}
 
 	GridItemInfo(const Common::String &groupHeader, int groupID) : title(groupHeader), description(groupHeader),
-		isHeader(true), validEntry(true), entryID(groupID), language(Common::UNK_LANG), platform(Common::kPlatformUnknown) {
+		isHeader(true), validEntry(true), entryID(groupID), language(Common::UNK_LANG), platform(Common::kPlatformUnknown), titleRows(0) {
 		thumbPath = Common::String("");
 	}
 };
@@ -105,6 +112,11 @@ protected:
 	Graphics::ManagedSurface *_disabledIconOverlay;
 	// Images are mapped by filename -> surface.
 	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
+	// The thumbnails of the visible entries are loaded a few at a time, and
+	// the ones not shown for the longest time are unloaded when there are too many
+	Common::HashMap<Common::String, uint32> _thumbnailLastUse;
+	uint32			_thumbnailUseCount;
+	bool			_thumbnailsPending;
 
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
@@ -195,6 +207,7 @@ public:
 	void saveClosedGroups(const Common::U32String &groupName);
 
 	void reloadThumbnails();
+	void unloadOldThumbnails();
 	void loadFlagIcons();
 	void loadPlatformIcons();
 	void loadExtraIcons();
@@ -216,6 +229,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
@@ -243,6 +257,7 @@ public:
 	void move(int x, int y);
 	void update();
 	void updateThumb();
+	void checkThumb();
 	void setActiveEntry(GridItemInfo &entry);
 
 	void drawWidget() override;
@@ -53,8 +53,9 @@ public:
 	struct ListData {
 		Common::U32String orig;
 		Common::U32String clean;
+		Common::U32String lower; ///< The clean string in lower case, which the filter is matched against
 
-		ListData(const Common::U32String &o, const Common::U32String &c) { orig = o; clean = c; }
+		ListData(const Common::U32String &o, const Common::U32String &c) { orig = o; clean = c; lower = c; lower.toLowercase(); }
 	};
 
 	typedef Common::Array<ListData> ListDataArray;
@@ -69,11 +69,18 @@ const Graphics::Surface *Indeo4Decoder::decodeFrame(Common::SeekableReadStream &
 	if (!isIndeo4(stream))
 		return nullptr;
 
-	// Set up the frame data buffer
-	byte *frameData = new byte[stream.size()];
-	stream.read(frameData, stream.size());
+	// Set up the frame data buffer. The data is only copied if the stream
+	// can't lend it, e.g. because it is in a memory mapped file.
+	const uint32 frameSize = stream.size();
+	byte *frameCopy = nullptr;
+	const byte *frameData = stream.borrow(frameSize);
+	if (!frameData) {
+		frameCopy = new byte[frameSize];
+		stream.read(frameCopy, frameSize);
+		frameData = frameCopy;
+	}
 	_ctx._frameData = frameData;
-	_ctx._frameSize = stream.size();
+	_ctx._frameSize = frameSize;
 
 	// Set up the GetBits instance for reading the data
 	_ctx._gb = new GetBits(_ctx._frameData, _ctx._frameSize);
@@ -84,7 +91,7 @@ const Graphics::Surface *Indeo4Decoder::decodeFrame(Common::SeekableReadStream &
 	// Free the bit reader and frame buffer
 	delete _ctx._gb;
 	_ctx._gb = nullptr;
-	delete[] frameData;
+	delete[] frameCopy;
 	_ctx._frameData = nullptr;
 	_ctx._frameSize = 0;
 
@@ -0,0 +1,127 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer_intern.h"
+
+#include "../null_osystem.h"
+
+namespace {
+
+/** A mono stream which never ends, with all samples at the same level. */
+class ConstantStream : public Audio::AudioStream {
+public:
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		for (int i = 0; i < numSamples; i++)
+			buffer[i] = 8000;
+		return numSamples;
+	}
+
+	bool isStereo() const override { return false; }
+	int getRate() const override { return 22050; }
+	bool endOfData() const override { return false; }
+};
+
+} // End of anonymous namespace
+
+class MixerTestSuite : public CxxTest::TestSuite {
+#if NULL_OSYSTEM_IS_AVAILABLE
+	// Whether the next mix pass outputs anything
+	static bool mixesSound(Audio::MixerImpl *mixer) {
+		int16 samples[2 * 256];
+		mixer->mixCallback((byte *)samples, sizeof(samples));
+
+		for (int i = 0; i < ARRAYSIZE(samples); i++) {
+			if (samples[i] != 0)
+				return true;
+		}
+		return false;
+	}
+
+public:
+	// Channel changes are applied in the order they were requested, even
+	// when they are queued for the next mix pass
+	void test_command_order() {
+		Common::install_null_g_system_with_mixer(22050);
+		Audio::MixerImpl *impl = Common::get_null_mixer();
+		Audio::Mixer *mixer = impl;
+
+		Audio::SoundHandle handle;
+		mixer->playStream(Audio::Mixer::kPlainSoundType, &handle, new ConstantStream());
+		mixer->setChannelVolume(handle, 0);
+		mixer->setChannelVolume(handle, 255);
+		TS_ASSERT(mixesSound(impl));
+
+		mixer->setChannelVolume(handle, 255);
+		mixer->setChannelVolume(handle, 0);
+		TS_ASSERT(!mixesSound(impl));
+
+		mixer->setChannelVolume(handle, 255);
+		mixer->pauseHandle(handle, true);
+		TS_ASSERT(!mixesSound(impl));
+		mixer->pauseHandle(handle, false);
+		TS_ASSERT(mixesSound(impl));
+
+		// More changes than the queue holds
+		for (int i = 0; i < 1000; i++)
+			mixer->setChannelVolume(handle, (byte)(i * 7));
+		TS_ASSERT_EQUALS(mixer->getChannelVolume(handle), (byte)(999 * 7));
+		mixer->setChannelVolume(handle, 0);
+		TS_ASSERT(!mixesSound(impl));
+
+		// A sound which isn't mixed yet is active, and its changes aren't
+		// dropped
+		Audio::SoundHandle queued;
+		mixer->playStream(Audio::Mixer::kPlainSoundType, &queued, new ConstantStream());
+		mixer->setChannelVolume(queued, 0);
+		TS_ASSERT(mixer->isSoundHandleActive(queued));
+		TS_ASSERT(!mixesSound(impl));
+		TS_ASSERT_EQUALS(mixer->getChannelVolume(queued), 0);
+
+		// Stopping applies the pending changes first
+		mixer->setChannelVolume(handle, 255);
+		mixer->stopHandle(handle);
+		TS_ASSERT(!mixer->isSoundHandleActive(handle));
+		TS_ASSERT(!mixesSound(impl));
+
+		mixer->stopAll();
+	}
+
+	// The getters answer with the requested state, before it is mixed
+	void test_getters() {
+		Common::install_null_g_system_with_mixer(22050);
+		Audio::MixerImpl *impl = Common::get_null_mixer();
+		Audio::Mixer *mixer = impl;
+
+		Audio::SoundHandle handle, withId;
+		mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, new ConstantStream(), -1, 100, -20);
+		mixer->playStream(Audio::Mixer::kSpeechSoundType, &withId, new ConstantStream(), 7);
+		TS_ASSERT(mixer->isSoundHandleActive(handle));
+		TS_ASSERT_EQUALS(mixer->getChannelVolume(handle), 100);
+		TS_ASSERT_EQUALS(mixer->getChannelBalance(handle), -20);
+		TS_ASSERT_EQUALS(mixer->getChannelRate(handle), 22050u);
+		TS_ASSERT_EQUALS(mixer->getSoundID(withId), 7);
+		TS_ASSERT(mixer->isSoundIDActive(7));
+		TS_ASSERT(mixer->hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+		TS_ASSERT(!mixer->hasActiveChannelOfType(Audio::Mixer::kMusicSoundType));
+
+		mixer->setChannelBalance(handle, 30);
+		mixer->setChannelRate(handle, 11025);
+		TS_ASSERT_EQUALS(mixer->getChannelBalance(handle), 30);
+		TS_ASSERT_EQUALS(mixer->getChannelRate(handle), 11025u);
+		mixer->resetChannelRate(handle);
+		TS_ASSERT_EQUALS(mixer->getChannelRate(handle), 22050u);
+		mixesSound(impl);
+		TS_ASSERT_EQUALS(mixer->getChannelBalance(handle), 30);
+
+		mixer->stopID(7);
+		TS_ASSERT(!mixer->isSoundIDActive(7));
+		TS_ASSERT(!mixer->isSoundHandleActive(withId));
+		TS_ASSERT_EQUALS(mixer->getSoundID(withId), 0);
+
+		mixer->stopAll();
+		TS_ASSERT(!mixer->isSoundHandleActive(handle));
+		TS_ASSERT_EQUALS(mixer->getChannelVolume(handle), 0);
+		TS_ASSERT(!mixer->hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+	}
+#endif
+};
@@ -0,0 +1,104 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer.h"
+#include "audio/rate_intern.h"
+
+#include "common/random.h"
+
+#include "test/instrset_detect.h"
+#include "test/audio/helper.h"
+
+class RateTestSuite : public CxxTest::TestSuite
+{
+	// Odd number of frames, so the scalar tail of the SIMD versions is used, too
+	static const int kNumFrames = 1021;
+
+	void checkMixFunc(Audio::RateMix::MixFunc (*getMixFunc)(bool, bool, bool)) {
+		Common::RandomSource rnd("rate");
+
+		int16 in[kNumFrames * 2];
+		int16 outRef[kNumFrames * 2], outTest[kNumFrames * 2];
+
+		for (int i = 0; i < kNumFrames * 2; ++i)
+			in[i] = (int16)rnd.getRandomNumber(0xFFFF);
+
+		const Audio::st_volume_t volumes[][2] = {
+			{ 0, 0 }, { 256, 256 }, { 255, 1 }, { 77, 200 }, { 256, 0 }
+		};
+
+		for (int layout = 0; layout < 5; ++layout) {
+			const bool inStereo = (layout < 3);
+			const bool outStereo = (layout != 2 && layout != 4);
+			const bool reverseStereo = (layout == 1);
+
+			Audio::RateMix::MixFunc refFunc = Audio::RateMix::getMixFuncGeneric(inStereo, outStereo, reverseStereo);
+			Audio::RateMix::MixFunc testFunc = getMixFunc(inStereo, outStereo, reverseStereo);
+
+			for (int v = 0; v < ARRAYSIZE(volumes); ++v) {
+				// Random output contents, so that the saturation is exercised
+				for (int i = 0; i < kNumFrames * 2; ++i)
+					outRef[i] = outTest[i] = (int16)rnd.getRandomNumber(0xFFFF);
+
+				refFunc(outRef, in, kNumFrames, volumes[v][0], volumes[v][1]);
+				testFunc(outTest, in, kNumFrames, volumes[v][0], volumes[v][1]);
+
+				for (int i = 0; i < kNumFrames * 2; ++i)
+					TS_ASSERT_EQUALS(outRef[i], outTest[i]);
+			}
+		}
+	}
+
+	void checkSinc(const int inRate, const int outRate) {
+		// A 1 Hz sine lies well within the pass band, so the output is
+		// expected to be the same sine at the output rate
+		Audio::SeekableAudioStream *s = createSineStream<int16>(inRate, 1, nullptr, false, false);
+		Audio::RateConverter *converter = Audio::makeSincRateConverter(inRate, outRate, false, false, false);
+
+		// One second of input, so one second of output
+		const int expectedFrames = outRate;
+		int16 *out = new int16[expectedFrames + 64];
+		memset(out, 0, (expectedFrames + 64) * sizeof(int16));
+
+		int numFrames = 0;
+		do {
+			numFrames += converter->convert(*s, out + numFrames, MIN(1000, expectedFrames + 64 - numFrames), Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		} while (numFrames < expectedFrames + 64 && converter->needsDraining());
+
+		TS_ASSERT_EQUALS(numFrames, expectedFrames);
+
+		// Skip the edges, where the filter sees the silence around the stream
+		const int maxValue = std::numeric_limits<int16>::max();
+		for (int i = 64; i < numFrames - 64; ++i) {
+			const int expected = (int)(sin((double)i / outRate * 2 * M_PI) * maxValue);
+			TS_ASSERT_LESS_THAN_EQUALS(ABS(out[i] - expected), 64);
+		}
+
+		delete[] out;
+		delete converter;
+		delete s;
+	}
+
+public:
+	void test_sinc_output() {
+		checkSinc(11025, 22050);
+		checkSinc(22050, 11025);
+		checkSinc(22050, 44100);
+		checkSinc(44100, 48000);
+		// More phases than the filter bank holds, so they are quantised
+		checkSinc(11025, 48000);
+	}
+
+	void test_mix_simd() {
+#ifdef SCUMMVM_NEON
+		checkMixFunc(Audio::RateMix::getMixFuncNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkMixFunc(Audio::RateMix::getMixFuncSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkMixFunc(Audio::RateMix::getMixFuncAVX2);
+#endif
+	}
+};
@@ -0,0 +1,473 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Throughput of the audio pipeline: decoders, rate converters, OPL
+ * emulators and the mixer. Run it with "make bench-audio"; see
+ * test/bench/bench.h for the options.
+ *
+ * Decoders for which we can't synthesize input read sample files from the
+ * --data directory: bench.mp3, bench.ogg, bench.flac, bench.wma (WMA in ASF)
+ * and bench.mov (QuickTime, e.g. QDM2 or AAC). Cases whose file is missing
+ * are reported as skipped.
+ *
+ * --resampler=linear|sinc selects the rate converter used by the mixer cases.
+ */
+
+#include "test/bench/bench.h"
+#include "test/null_osystem.h"
+
+#include "audio/audiostream.h"
+#include "audio/fmopl.h"
+#include "audio/mixer_intern.h"
+#include "audio/rate.h"
+#include "audio/decoders/adpcm.h"
+#include "audio/decoders/asf.h"
+#include "audio/decoders/flac.h"
+#include "audio/decoders/g711.h"
+#include "audio/decoders/mp3.h"
+#include "audio/decoders/quicktime.h"
+#include "audio/decoders/raw.h"
+#include "audio/decoders/vorbis.h"
+
+#include "common/config-manager.h"
+#include "common/func.h"
+#include "common/memstream.h"
+#include "common/random.h"
+
+namespace {
+
+enum {
+	kOutputRate = 44100,
+	kInputSize = 1024 * 1024,
+	kBufferSamples = 4096
+};
+
+/** Endless stream of noise, for the cases which only measure the consumer. */
+class NoiseStream : public Audio::AudioStream {
+public:
+	NoiseStream(int rate, bool stereo) : _rate(rate), _stereo(stereo), _pos(0) {
+		Common::RandomSource rnd("bench");
+		for (int i = 0; i < kNoiseSize; ++i)
+			_noise[i] = (int16)rnd.getRandomNumber(0xFFFF) / 4;
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		for (int done = 0; done < numSamples;) {
+			const int len = MIN<int>(numSamples - done, kNoiseSize - _pos);
+			memcpy(buffer + done, _noise + _pos, len * sizeof(int16));
+			done += len;
+			_pos = (_pos + len) % kNoiseSize;
+		}
+		return numSamples;
+	}
+
+	bool isStereo() const override { return _stereo; }
+	int getRate() const override { return _rate; }
+	bool endOfData() const override { return false; }
+
+private:
+	enum {
+		kNoiseSize = 16384
+	};
+
+	int16 _noise[kNoiseSize];
+	int _rate;
+	bool _stereo;
+	int _pos;
+};
+
+/** Decode @p stream completely and return the number of samples. */
+uint64 decodeAll(Audio::AudioStream *stream) {
+	if (!stream)
+		error("Could not create the audio stream");
+
+	int16 buffer[kBufferSamples];
+	uint64 samples = 0;
+
+	while (!stream->endOfData()) {
+		const int len = stream->readBuffer(buffer, kBufferSamples);
+		if (len <= 0)
+			break;
+		samples += len;
+	}
+
+	delete stream;
+	return samples;
+}
+
+struct ADPCMCase {
+	const char *name;
+	Audio::ADPCMType type;
+	int channels;
+	uint32 blockAlign;
+};
+
+const ADPCMCase adpcmCases[] = {
+	{ "oki",      Audio::kADPCMOki,    1, 0    },
+	{ "ms-ima",   Audio::kADPCMMSIma,  2, 2048 },
+	{ "ms",       Audio::kADPCMMS,     2, 2048 },
+	{ "dvi",      Audio::kADPCMDVI,    2, 0    },
+	{ "apple",    Audio::kADPCMApple,  2, 68   },
+	{ "dk3",      Audio::kADPCMDK3,    2, 2048 },
+	{ "xa",       Audio::kADPCMXA,     2, 0    }
+};
+
+/**
+ * Random data is valid ADPCM data, apart from some block header fields which
+ * the decoders trust. Fix these up.
+ */
+void fixADPCMHeaders(const ADPCMCase &c, byte *data, Common::RandomSource &rnd) {
+	switch (c.type) {
+	case Audio::kADPCMMSIma:
+		for (uint32 block = 0; block < kInputSize; block += c.blockAlign) {
+			for (int ch = 0; ch < c.channels; ++ch)
+				WRITE_LE_UINT16(data + block + ch * 4 + 2, rnd.getRandomNumber(88));
+		}
+		break;
+
+	case Audio::kADPCMDK3:
+		for (uint32 block = 0; block < kInputSize; block += c.blockAlign) {
+			WRITE_LE_UINT16(data + block + 2, kOutputRate);
+			data[block + 14] = rnd.getRandomNumber(88);
+			data[block + 15] = rnd.getRandomNumber(88);
+		}
+		break;
+
+	case Audio::kADPCMXA:
+		for (uint32 block = 0; block < kInputSize; block += 128) {
+			for (int i = 4; i < 12; ++i)
+				data[block + i] = (rnd.getRandomNumber(4) << 4) | rnd.getRandomNumber(12);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void benchDecoders(Bench::Runner &runner) {
+	Common::RandomSource rnd("bench");
+	byte *input = new byte[kInputSize];
+	for (uint32 i = 0; i < kInputSize; ++i)
+		input[i] = rnd.getRandomNumber(0xFF);
+
+	runner.run("decoder/raw-s16", "samples", [&]() {
+		return decodeAll(Audio::makeRawStream(input, kInputSize, kOutputRate, Audio::FLAG_16BITS | Audio::FLAG_STEREO, DisposeAfterUse::NO));
+	});
+
+	runner.run("decoder/raw-u8", "samples", [&]() {
+		return decodeAll(Audio::makeRawStream(input, kInputSize, kOutputRate, Audio::FLAG_UNSIGNED, DisposeAfterUse::NO));
+	});
+
+	runner.run("decoder/g711-alaw", "samples", [&]() {
+		return decodeAll(Audio::makeALawStream(new Common::MemoryReadStream(input, kInputSize), DisposeAfterUse::YES, kOutputRate, 2));
+	});
+
+	runner.run("decoder/g711-mulaw", "samples", [&]() {
+		return decodeAll(Audio::makeMuLawStream(new Common::MemoryReadStream(input, kInputSize), DisposeAfterUse::YES, kOutputRate, 2));
+	});
+
+	for (int i = 0; i < ARRAYSIZE(adpcmCases); ++i) {
+		const ADPCMCase &c = adpcmCases[i];
+
+		byte *data = new byte[kInputSize];
+		memcpy(data, input, kInputSize);
+		fixADPCMHeaders(c, data, rnd);
+
+		runner.run(Common::String("decoder/adpcm-") + c.name, "samples", [&]() {
+			return decodeAll(Audio::makeADPCMStream(new Common::MemoryReadStream(data, kInputSize), DisposeAfterUse::YES, kInputSize, c.type, kOutputRate, c.channels, c.blockAlign));
+		});
+
+		delete[] data;
+	}
+
+	delete[] input;
+}
+
+typedef Audio::SeekableAudioStream *(*FileDecoderFactory)(Common::SeekableReadStream *stream);
+
+struct FileDecoderCase {
+	const char *name;
+	const char *fileName;
+	FileDecoderFactory factory;
+};
+
+#ifdef USE_MAD
+Audio::SeekableAudioStream *makeMP3(Common::SeekableReadStream *stream) {
+	return Audio::makeMP3Stream(stream, DisposeAfterUse::YES);
+}
+#endif
+
+#if defined(USE_VORBIS) || defined(USE_TREMOR)
+Audio::SeekableAudioStream *makeVorbis(Common::SeekableReadStream *stream) {
+	return Audio::makeVorbisStream(stream, DisposeAfterUse::YES);
+}
+#endif
+
+#ifdef USE_FLAC
+Audio::SeekableAudioStream *makeFLAC(Common::SeekableReadStream *stream) {
+	return Audio::makeFLACStream(stream, DisposeAfterUse::YES);
+}
+#endif
+
+Audio::SeekableAudioStream *makeASF(Common::SeekableReadStream *stream) {
+	return Audio::makeASFStream(stream, DisposeAfterUse::YES);
+}
+
+Audio::SeekableAudioStream *makeQuickTime(Common::SeekableReadStream *stream) {
+	return Audio::makeQuickTimeStream(stream, DisposeAfterUse::YES);
+}
+
+const FileDecoderCase fileDecoderCases[] = {
+#ifdef USE_MAD
+	{ "mp3",       "bench.mp3",  makeMP3       },
+#else
+	{ "mp3",       "bench.mp3",  nullptr       },
+#endif
+#if defined(USE_VORBIS) || defined(USE_TREMOR)
+	{ "vorbis",    "bench.ogg",  makeVorbis    },
+#else
+	{ "vorbis",    "bench.ogg",  nullptr       },
+#endif
+#ifdef USE_FLAC
+	{ "flac",      "bench.flac", makeFLAC      },
+#else
+	{ "flac",      "bench.flac", nullptr       },
+#endif
+	{ "wma",       "bench.wma",  makeASF       },
+	{ "quicktime", "bench.mov",  makeQuickTime }
+};
+
+void benchFileDecoders(Bench::Runner &runner) {
+	for (int i = 0; i < ARRAYSIZE(fileDecoderCases); ++i) {
+		const FileDecoderCase &c = fileDecoderCases[i];
+		const Common::String name = Common::String("decoder/") + c.name;
+
+		if (!c.factory) {
+			runner.skip(name, "decoder not enabled in this build");
+			continue;
+		}
+
+		Common::SeekableReadStream *file = runner.openDataFile(c.fileName);
+		if (!file) {
+			runner.skip(name, "sample file not found in the data directory");
+			continue;
+		}
+
+		// Decode from memory, so that only the decoder is measured
+		const uint32 size = file->size();
+		byte *data = new byte[size];
+		file->read(data, size);
+		delete file;
+
+		runner.run(name, "samples", [&]() {
+			return decodeAll(c.factory(new Common::MemoryReadStream(data, size)));
+		});
+
+		delete[] data;
+	}
+}
+
+struct RateCase {
+	int inRate;
+	int outRate;
+};
+
+const RateCase rateCases[] = {
+	{ 11025, 44100 },
+	{ 22050, 44100 },
+	{ 44100, 44100 },
+	{ 32000, 48000 },
+	{ 48000, 44100 }
+};
+
+void benchRateConverters(Bench::Runner &runner) {
+	const Audio::RateConverterType types[] = { Audio::kRateConverterLinear, Audio::kRateConverterSinc };
+	const char *const typeNames[] = { "linear", "sinc" };
+
+	for (int type = 0; type < ARRAYSIZE(types); ++type) {
+		for (int i = 0; i < ARRAYSIZE(rateCases); ++i) {
+			for (int inStereo = 0; inStereo < 2; ++inStereo) {
+				const RateCase &c = rateCases[i];
+				const Common::String name = Common::String::format("rate/%s-%d-%d-%s", typeNames[type], c.inRate, c.outRate, inStereo ? "stereo" : "mono");
+
+				NoiseStream input(c.inRate, inStereo);
+				Audio::RateConverter *converter = Audio::makeRateConverter(c.inRate, c.outRate, inStereo, true, false, types[type]);
+				Audio::st_sample_t output[kBufferSamples * 2];
+
+				runner.run(name, "frames", [&]() {
+					memset(output, 0, sizeof(output));
+					return converter->convert(input, output, kBufferSamples, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+				});
+
+				delete converter;
+			}
+		}
+	}
+}
+
+/**
+ * Keeps some notes playing on the OPL, changing a few of them on every
+ * timer tick like a music player would.
+ */
+class OPLPlayer {
+public:
+	OPLPlayer(OPL::OPL *opl, bool opl3) : _opl(opl), _opl3(opl3), _rnd("bench") {
+		if (_opl3)
+			_opl->writeReg(0x105, 0x01);
+
+		for (int ch = 0; ch < (_opl3 ? 18 : 9); ++ch)
+			setupChannel(ch);
+	}
+
+	void onTimer() {
+		for (int i = 0; i < 2; ++i)
+			keyOn(_rnd.getRandomNumber(_opl3 ? 17 : 8));
+	}
+
+private:
+	static int getBase(int ch) {
+		return ch >= 9 ? 0x100 : 0;
+	}
+
+	static int getOperatorOffset(int ch) {
+		static const int offsets[9] = { 0, 1, 2, 8, 9, 10, 16, 17, 18 };
+		return offsets[ch % 9];
+	}
+
+	void setupChannel(int ch) {
+		const int base = getBase(ch);
+		const int op = getOperatorOffset(ch);
+
+		for (int i = 0; i < 2; ++i) {
+			_opl->writeReg(base + 0x20 + op + i * 3, 0x21);
+			_opl->writeReg(base + 0x40 + op + i * 3, i ? 0x00 : 0x10);
+			_opl->writeReg(base + 0x60 + op + i * 3, 0xF4);
+			_opl->writeReg(base + 0x80 + op + i * 3, 0x56);
+			_opl->writeReg(base + 0xE0 + op + i * 3, _rnd.getRandomNumber(_opl3 ? 7 : 3));
+		}
+		_opl->writeReg(base + 0xC0 + ch % 9, 0x30 | (_rnd.getRandomNumber(7) << 1));
+		keyOn(ch);
+	}
+
+	void keyOn(int ch) {
+		const int base = getBase(ch);
+		const int fnum = 0x200 + _rnd.getRandomNumber(0x1FF);
+
+		_opl->writeReg(base + 0xB0 + ch % 9, 0);
+		_opl->writeReg(base + 0xA0 + ch % 9, fnum & 0xFF);
+		_opl->writeReg(base + 0xB0 + ch % 9, 0x20 | ((2 + _rnd.getRandomNumber(3)) << 2) | (fnum >> 8));
+	}
+
+	OPL::OPL *_opl;
+	bool _opl3;
+	Common::RandomSource _rnd;
+};
+
+/** Mix one buffer of output and return the number of frames. */
+uint64 mixBuffer(Audio::MixerImpl *mixer) {
+	static byte buffer[kBufferSamples * 4];
+	mixer->mixCallback(buffer, sizeof(buffer));
+	return kBufferSamples;
+}
+
+void benchOPL(Bench::Runner &runner, Audio::MixerImpl *mixer) {
+	// The hardware OPL drivers can't be measured here
+	static const char *const emulators[] = { "mame", "db", "nuked" };
+
+	for (int i = 0; i < ARRAYSIZE(emulators); ++i) {
+		OPL::Config::DriverId id = OPL::Config::parse(emulators[i]);
+		if (id == -1) {
+			runner.skip(Common::String("opl/") + emulators[i], "emulator not enabled in this build");
+			continue;
+		}
+
+		for (int opl3 = 0; opl3 < 2; ++opl3) {
+			const Common::String name = Common::String::format("opl/%s-%s", emulators[i], opl3 ? "opl3" : "opl2");
+
+			OPL::OPL *opl = OPL::Config::create(id, opl3 ? OPL::Config::kOpl3 : OPL::Config::kOpl2);
+			if (!opl) {
+				runner.skip(name, "emulator does not support this chip");
+				continue;
+			}
+			if (!opl->init())
+				error("Could not initialize OPL emulator '%s'", emulators[i]);
+
+			OPLPlayer player(opl, opl3);
+			opl->start(new Common::Functor0Mem<void, OPLPlayer>(&player, &OPLPlayer::onTimer));
+
+			runner.run(name, "frames", [&]() {
+				return mixBuffer(mixer);
+			});
+
+			delete opl;
+		}
+	}
+}
+
+void benchMixer(Bench::Runner &runner, Audio::MixerImpl *mixer) {
+	static const int channelCounts[] = { 1, 8, 32 };
+
+	for (int i = 0; i < ARRAYSIZE(channelCounts); ++i) {
+		const int channels = channelCounts[i];
+
+		// A mix of the rates and formats games use
+		for (int ch = 0; ch < channels; ++ch) {
+			const bool stereo = (ch % 2) != 0;
+			const int rate = (ch % 3 == 0) ? kOutputRate : 22050;
+			mixer->playStream(Audio::Mixer::kSFXSoundType, nullptr, new NoiseStream(rate, stereo), -1, Audio::Mixer::kMaxChannelVolume / 2, (ch % 5) * 20 - 40, DisposeAfterUse::YES, false, false);
+		}
+
+		runner.run(Common::String::format("mixer/%dch", channels), "frames", [&]() {
+			return mixBuffer(mixer);
+		});
+
+		mixer->stopAll();
+	}
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	Bench::Runner runner("audio", argc, argv);
+
+	Common::install_null_g_system_with_mixer(kOutputRate, false);
+
+	const Common::String resampler = runner.getOption("resampler");
+	if (!resampler.empty())
+		ConfMan.set("audio_resampler", resampler);
+
+	Audio::MixerImpl *mixer = Common::get_null_mixer();
+
+	runner.addInfo("sse2", g_system->hasFeature(OSystem::kFeatureCpuSSE2) ? "yes" : "no");
+	runner.addInfo("avx2", g_system->hasFeature(OSystem::kFeatureCpuAVX2) ? "yes" : "no");
+	runner.addInfo("neon", g_system->hasFeature(OSystem::kFeatureCpuNEON) ? "yes" : "no");
+	runner.addInfo("resampler", resampler.empty() ? "linear" : resampler);
+
+	benchDecoders(runner);
+	benchFileDecoders(runner);
+	benchRateConverters(runner);
+	benchOPL(runner, mixer);
+	benchMixer(runner, mixer);
+
+	return runner.finish();
+}
@@ -0,0 +1,293 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TEST_BENCH_BENCH_H
+#define TEST_BENCH_BENCH_H
+
+#include "common/array.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+/**
+ * Minimal harness for the microbenchmarks in test/bench.
+ *
+ * Every benchmark case is a functor which does one batch of work and returns
+ * the number of items (samples, pixels, ...) it processed. The runner calls
+ * it until the minimum time has passed, repeats that for the configured
+ * number of runs and keeps the best throughput, which is the most stable
+ * number on a machine doing other things. The results are written as JSON
+ * or CSV, so that they can be compared between builds and machines.
+ *
+ * Command line options:
+ *  --time=MSECS    minimum time per run (default 500)
+ *  --runs=N        number of runs per case (default 3)
+ *  --format=FMT    "json" (default) or "csv"
+ *  --output=FILE   write the report there instead of to the console
+ *  --data=DIR      directory with sample files for cases which need them
+ * Any other argument is a filter; only cases whose name contains one of the
+ * filters are run.
+ *
+ * Suites may accept additional "--name=value" options, see getOption().
+ *
+ * The system must be installed with logging enabled, as the report and the
+ * progress messages are written through OSystem::logMessage().
+ */
+namespace Bench {
+
+class Runner {
+public:
+	Runner(const char *suite, int argc, char *argv[]) : _suite(suite), _minTime(500), _runs(3) {
+		for (int i = 1; i < argc; ++i) {
+			const Common::String arg(argv[i]);
+			if (!arg.hasPrefix("--")) {
+				_filters.push_back(arg);
+				continue;
+			}
+
+			const size_t eq = arg.findFirstOf('=');
+			if (eq == Common::String::npos)
+				error("Option '%s' needs a value", arg.c_str());
+
+			Option option;
+			option.name = Common::String(arg.c_str() + 2, eq - 2);
+			option.value = Common::String(arg.c_str() + eq + 1);
+			_options.push_back(option);
+		}
+
+		_minTime = getIntOption("time", _minTime);
+		_runs = MAX(1, getIntOption("runs", _runs));
+	}
+
+	/** Return the value of option --@p name, or @p defaultValue if it was not given. */
+	Common::String getOption(const char *name, const char *defaultValue = "") const {
+		for (uint i = 0; i < _options.size(); ++i) {
+			if (_options[i].name == name)
+				return _options[i].value;
+		}
+		return defaultValue;
+	}
+
+	int getIntOption(const char *name, int defaultValue) const {
+		const Common::String value = getOption(name);
+		return value.empty() ? defaultValue : (int)value.asUint64();
+	}
+
+	/**
+	 * Open @p fileName in the --data directory, or return nullptr if there
+	 * is no such file.
+	 */
+	Common::SeekableReadStream *openDataFile(const char *fileName) const {
+		const Common::String dir = getOption("data");
+		if (dir.empty())
+			return nullptr;
+
+		const Common::FSNode node = Common::FSNode(Common::Path(dir, Common::Path::kNativeSeparator)).getChild(fileName);
+		if (!node.exists())
+			return nullptr;
+
+		return node.createReadStream();
+	}
+
+	bool wanted(const Common::String &name) const {
+		if (_filters.empty())
+			return true;
+
+		for (uint i = 0; i < _filters.size(); ++i) {
+			if (name.contains(_filters[i]))
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Measure @p func, which does one batch of work and returns the number of
+	 * @p unit it processed.
+	 */
+	template<class Func>
+	void run(const Common::String &name, const char *unit, Func func) {
+		if (!wanted(name))
+			return;
+
+		// Warm up caches and lazily initialized tables
+		func();
+
+		Result result;
+		result.name = name;
+		result.unit = unit;
+		result.value = 0;
+
+		for (int run = 0; run < _runs; ++run) {
+			uint64 count = 0;
+			const uint32 start = g_system->getMillis(true);
+			uint32 elapsed;
+			do {
+				count += func();
+				elapsed = g_system->getMillis(true) - start;
+			} while (elapsed < (uint32)_minTime);
+
+			const double perSecond = count * 1000.0 / elapsed;
+			if (perSecond > result.value)
+				result.value = perSecond;
+		}
+
+		// Progress goes to stderr, keeping stdout for the report
+		const Common::String line = Common::String::format("%s: %.0f %s/s\n", name.c_str(), result.value, unit);
+		g_system->logMessage(LogMessageType::kWarning, line.c_str());
+		_results.push_back(result);
+	}
+
+	/** Record that case @p name could not be run in this build or setup. */
+	void skip(const Common::String &name, const char *reason) {
+		if (!wanted(name))
+			return;
+
+		Result result;
+		result.name = name;
+		result.value = 0;
+		result.skipped = reason;
+		_results.push_back(result);
+	}
+
+	/** Add a property of the build or machine to the report. */
+	void addInfo(const char *name, const Common::String &value) {
+		Option info;
+		info.name = name;
+		info.value = value;
+		_info.push_back(info);
+	}
+
+	/** Write the report; returns the exit code for main(). */
+	int finish() const {
+		const Common::String format = getOption("format", "json");
+		Common::String report;
+		if (format == "csv")
+			report = formatCSV();
+		else if (format == "json")
+			report = formatJSON();
+		else
+			error("Unknown report format '%s'", format.c_str());
+
+		const Common::String output = getOption("output");
+		if (output.empty()) {
+			g_system->logMessage(LogMessageType::kInfo, report.c_str());
+			return 0;
+		}
+
+		Common::DumpFile file;
+		if (!file.open(Common::FSNode(Common::Path(output, Common::Path::kNativeSeparator)))) {
+			warning("Could not write '%s'", output.c_str());
+			return 1;
+		}
+		file.writeString(report);
+		return 0;
+	}
+
+private:
+	struct Option {
+		Common::String name;
+		Common::String value;
+	};
+
+	struct Result {
+		Common::String name;
+		Common::String unit;
+		double value;
+		Common::String skipped;
+	};
+
+	Common::String formatJSON() const {
+		Common::String json = Common::String::format("{\n\t\"suite\": \"%s\",\n\t\"time\": %d,\n\t\"runs\": %d,\n\t\"info\": {", _suite, _minTime, _runs);
+		for (uint i = 0; i < _info.size(); ++i)
+			json += Common::String::format("%s\n\t\t\"%s\": \"%s\"", i ? "," : "", escape(_info[i].name).c_str(), escape(_info[i].value).c_str());
+		json += "\n\t},\n\t\"results\": [";
+
+		for (uint i = 0; i < _results.size(); ++i) {
+			const Result &result = _results[i];
+			json += Common::String::format("%s\n\t\t{ \"name\": \"%s\", ", i ? "," : "", escape(result.name).c_str());
+			if (!result.skipped.empty())
+				json += Common::String::format("\"skipped\": \"%s\" }", escape(result.skipped).c_str());
+			else
+				json += Common::String::format("\"unit\": \"%s/s\", \"value\": %.0f }", result.unit.c_str(), result.value);
+		}
+		json += "\n\t]\n}\n";
+		return json;
+	}
+
+	/** One line per case; the info is repeated in every line, for merging the files of several machines. */
+	Common::String formatCSV() const {
+		Common::String csv = "suite";
+		for (uint i = 0; i < _info.size(); ++i)
+			csv += "," + csvField(_info[i].name);
+		csv += ",name,unit,value,skipped\n";
+
+		Common::String prefix = csvField(_suite);
+		for (uint i = 0; i < _info.size(); ++i)
+			prefix += "," + csvField(_info[i].value);
+
+		for (uint i = 0; i < _results.size(); ++i) {
+			const Result &result = _results[i];
+			if (!result.skipped.empty())
+				csv += Common::String::format("%s,%s,,,%s\n", prefix.c_str(), csvField(result.name).c_str(), csvField(result.skipped).c_str());
+			else
+				csv += Common::String::format("%s,%s,%s/s,%.0f,\n", prefix.c_str(), csvField(result.name).c_str(), result.unit.c_str(), result.value);
+		}
+		return csv;
+	}
+
+	/** Quotes @p str if it holds a separator, a quote or a line break, doubling the quotes. */
+	static Common::String csvField(const Common::String &str) {
+		if (!str.contains(',') && !str.contains('"') && !str.contains('\n') && !str.contains('\r'))
+			return str;
+
+		Common::String result = "\"";
+		for (uint i = 0; i < str.size(); ++i) {
+			if (str[i] == '"')
+				result += '"';
+			result += str[i];
+		}
+		return result + "\"";
+	}
+
+	static Common::String escape(const Common::String &str) {
+		Common::String result;
+		for (uint i = 0; i < str.size(); ++i) {
+			if (str[i] == '"' || str[i] == '\\')
+				result += '\\';
+			result += str[i];
+		}
+		return result;
+	}
+
+	const char *_suite;
+	int _minTime;
+	int _runs;
+	Common::Array<Common::String> _filters;
+	Common::Array<Option> _options;
+	Common::Array<Option> _info;
+	Common::Array<Result> _results;
+};
+
+} // End of namespace Bench
+
+#endif
@@ -0,0 +1,518 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Throughput of the graphics primitives: the plain, color key, format
+ * converting, scaling and rotating blits, the blending blitter, the scaler
+ * plugins, the YUV to RGB conversion and the shapes of the vector renderer
+ * of the GUI themes. Run it with "make bench-graphics"; see
+ * test/bench/bench.h for the options.
+ *
+ * The blending blitter picks its fastest SIMD implementation by itself; the
+ * CPU features in the report tell which one was measured.
+ *
+ * All cases count the pixels written. The surface sizes can be set with
+ * --sizes=WxH,WxH,... (default 320x200,640x480,1280x720). The vector
+ * renderer draws in the overlay format of the null backend.
+ */
+
+#include "test/bench/bench.h"
+#include "test/null_osystem.h"
+
+#include "base/plugins.h"
+
+#include "common/random.h"
+#include "common/tokenizer.h"
+
+#include "graphics/blit.h"
+#include "graphics/managed_surface.h"
+#include "graphics/scalerplugin.h"
+#include "graphics/transform_tools.h"
+#include "graphics/VectorRendererSpec.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+/** The scaler plugins, the same ones StaticPluginProvider links. */
+static Common::Array<ScalerPluginObject *> createScalerPlugins() {
+	Common::Array<ScalerPluginObject *> plugins;
+
+	#define LINK_PLUGIN(ID) \
+		extern PluginObject *g_##ID##_getObject(); \
+		plugins.push_back((ScalerPluginObject *)g_##ID##_getObject());
+
+	LINK_PLUGIN(NORMAL)
+#ifdef USE_SCALERS
+#ifdef USE_HQ_SCALERS
+	LINK_PLUGIN(HQ)
+#endif
+#ifdef USE_EDGE_SCALERS
+	LINK_PLUGIN(EDGE)
+#endif
+	LINK_PLUGIN(ADVMAME)
+	LINK_PLUGIN(SAI)
+	LINK_PLUGIN(SUPERSAI)
+	LINK_PLUGIN(SUPEREAGLE)
+	LINK_PLUGIN(PM)
+	LINK_PLUGIN(DOTMATRIX)
+	LINK_PLUGIN(TV)
+#endif
+
+	#undef LINK_PLUGIN
+
+	return plugins;
+}
+
+namespace {
+
+struct Size {
+	int w, h;
+};
+
+struct NamedFormat {
+	const char *name;
+	Graphics::PixelFormat format;
+};
+
+enum {
+	kRGB565,
+	kARGB8888,
+	kRGBA8888,
+	kNumFormats
+};
+
+void getFormats(NamedFormat (&formats)[kNumFormats]) {
+	formats[kRGB565].name = "rgb565";
+	formats[kRGB565].format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+	formats[kARGB8888].name = "argb8888";
+	formats[kARGB8888].format = Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24);
+	formats[kRGBA8888].name = "rgba8888";
+	formats[kRGBA8888].format = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+}
+
+Common::Array<Size> parseSizes(const Common::String &option) {
+	Common::Array<Size> sizes;
+	Common::StringTokenizer tokenizer(option, ",");
+	while (!tokenizer.empty()) {
+		const Common::String token = tokenizer.nextToken();
+		const size_t x = token.findFirstOf('x');
+		Size size;
+		size.w = (x == Common::String::npos) ? 0 : (int)Common::String(token.c_str(), x).asUint64();
+		size.h = (x == Common::String::npos) ? 0 : (int)Common::String(token.c_str() + x + 1).asUint64();
+		if (size.w <= 0 || size.h <= 0)
+			error("Invalid surface size '%s'", token.c_str());
+		sizes.push_back(size);
+	}
+	return sizes;
+}
+
+/** Noise, including the alpha channel, so that no blending case takes a shortcut. */
+void fillNoise(byte *pixels, uint size) {
+	Common::RandomSource rnd("bench");
+	for (uint i = 0; i < size; ++i)
+		pixels[i] = rnd.getRandomNumber(255);
+}
+
+void fillNoise(Graphics::Surface &surface) {
+	fillNoise((byte *)surface.getPixels(), surface.pitch * surface.h);
+}
+
+Common::String sizeName(const Size &size) {
+	return Common::String::format("%dx%d", size.w, size.h);
+}
+
+void benchBlits(Bench::Runner &runner, const Size &size, const NamedFormat (&formats)[kNumFormats]) {
+	const uint64 pixels = (uint64)size.w * size.h;
+
+	for (int bpp = 1; bpp <= 4; bpp *= 2) {
+		const Graphics::PixelFormat format = bpp == 1 ? Graphics::PixelFormat::createFormatCLUT8() : formats[bpp == 2 ? kRGB565 : kARGB8888].format;
+		Graphics::Surface src, dst;
+		src.create(size.w, size.h, format);
+		dst.create(size.w, size.h, format);
+		fillNoise(src);
+
+		runner.run(Common::String::format("blit/copy-%dbpp-", bpp) + sizeName(size), "pixels", [&]() {
+			Graphics::copyBlit((byte *)dst.getPixels(), (const byte *)src.getPixels(), dst.pitch, src.pitch, size.w, size.h, bpp);
+			return pixels;
+		});
+
+		runner.run(Common::String::format("blit/key-%dbpp-", bpp) + sizeName(size), "pixels", [&]() {
+			Graphics::keyBlit((byte *)dst.getPixels(), (const byte *)src.getPixels(), dst.pitch, src.pitch, size.w, size.h, bpp, 0);
+			return pixels;
+		});
+
+		src.free();
+		dst.free();
+	}
+
+	// The conversions done when games and the backends use different formats
+	static const int crossPairs[][2] = {
+		{ kRGB565, kARGB8888 },
+		{ kARGB8888, kRGB565 },
+		{ kRGBA8888, kARGB8888 }
+	};
+	for (int i = 0; i < ARRAYSIZE(crossPairs); ++i) {
+		const NamedFormat &srcFormat = formats[crossPairs[i][0]];
+		const NamedFormat &dstFormat = formats[crossPairs[i][1]];
+		Graphics::Surface src, dst;
+		src.create(size.w, size.h, srcFormat.format);
+		dst.create(size.w, size.h, dstFormat.format);
+		fillNoise(src);
+
+		runner.run(Common::String::format("blit/cross-%s-%s-", srcFormat.name, dstFormat.name) + sizeName(size), "pixels", [&]() {
+			Graphics::crossBlit((byte *)dst.getPixels(), (const byte *)src.getPixels(), dst.pitch, src.pitch, size.w, size.h, dstFormat.format, srcFormat.format);
+			return pixels;
+		});
+
+		src.free();
+		dst.free();
+	}
+
+	for (int f = kRGB565; f <= kARGB8888; ++f) {
+		const NamedFormat &format = formats[f];
+
+		// Upscaling by 2, as for the low resolution videos
+		Graphics::Surface src, dst;
+		src.create(size.w / 2, size.h / 2, format.format);
+		dst.create(size.w, size.h, format.format);
+		fillNoise(src);
+
+		runner.run(Common::String::format("blit/scale-%s-", format.name) + sizeName(size), "pixels", [&]() {
+			Graphics::scaleBlit((byte *)dst.getPixels(), (const byte *)src.getPixels(), dst.pitch, src.pitch, dst.w, dst.h, src.w, src.h, format.format);
+			return pixels;
+		});
+
+		runner.run(Common::String::format("blit/scale-bilinear-%s-", format.name) + sizeName(size), "pixels", [&]() {
+			Graphics::scaleBlitBilinear((byte *)dst.getPixels(), (const byte *)src.getPixels(), dst.pitch, src.pitch, dst.w, dst.h, src.w, src.h, format.format);
+			return pixels;
+		});
+
+		src.free();
+		dst.free();
+
+		// Rotating by 30 degrees and zooming by 1.5
+		src.create(size.w, size.h, format.format);
+		fillNoise(src);
+
+		const Graphics::TransformStruct transform(Graphics::kDefaultZoomX * 3 / 2, Graphics::kDefaultZoomY * 3 / 2, 30, size.w / 2, size.h / 2);
+		Common::Point hotspot;
+		const Common::Rect rect = Graphics::TransformTools::newRect(Common::Rect(size.w, size.h), transform, &hotspot);
+		dst.create(rect.width(), rect.height(), format.format);
+		const uint64 rotatedPixels = (uint64)dst.w * dst.h;
+
+		runner.run(Common::String::format("blit/rotoscale-%s-", format.name) + sizeName(size), "pixels", [&]() {
+			Graphics::rotoscaleBlit((byte *)dst.getPixels(), (const byte *)src.getPixels(), dst.pitch, src.pitch, dst.w, dst.h, src.w, src.h, format.format, transform, hotspot);
+			return rotatedPixels;
+		});
+
+		runner.run(Common::String::format("blit/rotoscale-bilinear-%s-", format.name) + sizeName(size), "pixels", [&]() {
+			Graphics::rotoscaleBlitBilinear((byte *)dst.getPixels(), (const byte *)src.getPixels(), dst.pitch, src.pitch, dst.w, dst.h, src.w, src.h, format.format, transform, hotspot);
+			return rotatedPixels;
+		});
+
+		src.free();
+		dst.free();
+	}
+}
+
+struct BlendCase {
+	const char *name;
+	Graphics::TSpriteBlendMode blendMode;
+	Graphics::AlphaType alphaType;
+	uint colorMod;
+	bool scaled;
+};
+
+const BlendCase blendCases[] = {
+	{ "opaque",   Graphics::BLEND_NORMAL,   Graphics::ALPHA_OPAQUE, MS_ARGB(255, 255, 255, 255), false },
+	{ "binary",   Graphics::BLEND_NORMAL,   Graphics::ALPHA_BINARY, MS_ARGB(255, 255, 255, 255), false },
+	{ "full",     Graphics::BLEND_NORMAL,   Graphics::ALPHA_FULL,   MS_ARGB(255, 255, 255, 255), false },
+	{ "tinted",   Graphics::BLEND_NORMAL,   Graphics::ALPHA_FULL,   MS_ARGB(192, 255, 128, 64),  false },
+	{ "additive", Graphics::BLEND_ADDITIVE, Graphics::ALPHA_FULL,   MS_ARGB(255, 255, 255, 255), false },
+	{ "multiply", Graphics::BLEND_MULTIPLY, Graphics::ALPHA_FULL,   MS_ARGB(255, 255, 255, 255), false },
+	{ "scaled",   Graphics::BLEND_NORMAL,   Graphics::ALPHA_FULL,   MS_ARGB(255, 255, 255, 255), true  }
+};
+
+void benchBlendBlit(Bench::Runner &runner, const Size &size) {
+	const Graphics::PixelFormat format = Graphics::BlendBlit::getSupportedPixelFormat();
+	const uint64 pixels = (uint64)size.w * size.h;
+
+	Graphics::ManagedSurface src(size.w, size.h, format), halfSrc(size.w / 2, size.h / 2, format), dst(size.w, size.h, format);
+	fillNoise(*src.surfacePtr());
+	fillNoise(*halfSrc.surfacePtr());
+
+	for (int i = 0; i < ARRAYSIZE(blendCases); ++i) {
+		const BlendCase &c = blendCases[i];
+		Graphics::ManagedSurface &source = c.scaled ? halfSrc : src;
+
+		runner.run(Common::String::format("blend/%s-", c.name) + sizeName(size), "pixels", [&]() {
+			source.blendBlitTo(dst, 0, 0, Graphics::FLIP_NONE, nullptr, c.colorMod, size.w, size.h, c.blendMode, c.alphaType);
+			return pixels;
+		});
+	}
+}
+
+void benchScalers(Bench::Runner &runner, const Size &size, const NamedFormat (&formats)[kNumFormats]) {
+	const Common::Array<ScalerPluginObject *> plugins = createScalerPlugins();
+
+	for (uint p = 0; p < plugins.size(); ++p) {
+		ScalerPluginObject *plugin = plugins[p];
+		const int padding = plugin->extraPixels();
+		const Common::Array<uint> &factors = plugin->getFactors();
+
+		for (int f = kRGB565; f <= kARGB8888; ++f) {
+			const NamedFormat &format = formats[f];
+
+			// The backends keep a border around the game screen for the scalers which read beyond it
+			Graphics::Surface src;
+			src.create(size.w + 2 * padding, size.h + 2 * padding, format.format);
+			fillNoise(src);
+			const byte *srcPtr = (const byte *)src.getBasePtr(padding, padding);
+
+			for (uint i = 0; i < factors.size(); ++i) {
+				const uint factor = factors[i];
+				Scaler *scaler = plugin->createInstance(format.format);
+				scaler->setFactor(factor);
+
+				Graphics::Surface dst;
+				dst.create(size.w * factor, size.h * factor, format.format);
+				const uint64 pixels = (uint64)dst.w * dst.h;
+
+				runner.run(Common::String::format("scaler/%s-%ux-%s-", plugin->getName(), factor, format.name) + sizeName(size), "pixels", [&]() {
+					scaler->scale(srcPtr, src.pitch, (byte *)dst.getPixels(), dst.pitch, size.w, size.h, 0, 0);
+					return pixels;
+				});
+
+				dst.free();
+				delete scaler;
+			}
+
+			src.free();
+		}
+
+		delete plugin;
+	}
+}
+
+/** The reference conversion of YUVToRGBRow, for comparison with the SIMD ones. */
+struct GenericYUVToRGBRow {
+	template<typename PixelInt, bool halfChroma, bool alpha>
+	static void convert(byte *dst, const byte *ySrc, const byte *aSrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const Graphics::YUVToRGBRowParams &params) {
+		Graphics::YUVToRGBRow::convertGeneric<PixelInt, halfChroma, alpha>(dst, ySrc, aSrc, rOffsets, gOffsets, bOffsets, 0, width, params);
+	}
+};
+
+void benchYUV(Bench::Runner &runner, const Size &size, const NamedFormat (&formats)[kNumFormats]) {
+	const uint64 pixels = (uint64)size.w * size.h;
+
+	byte *planes = new byte[size.w * size.h * 4];
+	fillNoise(planes, size.w * size.h * 4);
+	const byte *ySrc = planes;
+	const byte *uSrc = planes + size.w * size.h;
+	const byte *vSrc = planes + size.w * size.h * 2;
+	const byte *aSrc = planes + size.w * size.h * 3;
+
+	struct RowBackend {
+		const char *name;
+		Graphics::YUVToRGBRow::ConvertFunc (*getConvertFunc)(uint, bool, bool);
+	};
+	Common::Array<RowBackend> rowBackends;
+	const RowBackend generic = { "generic", &Graphics::YUVToRGBRow::selectConvertFunc<GenericYUVToRGBRow> };
+	rowBackends.push_back(generic);
+#ifdef SCUMMVM_NEON
+	const RowBackend neon = { "neon", &Graphics::YUVToRGBRow::getConvertFuncNEON };
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		rowBackends.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+	const RowBackend sse2 = { "sse2", &Graphics::YUVToRGBRow::getConvertFuncSSE2 };
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		rowBackends.push_back(sse2);
+#endif
+#ifdef SCUMMVM_AVX2
+	const RowBackend avx2 = { "avx2", &Graphics::YUVToRGBRow::getConvertFuncAVX2 };
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		rowBackends.push_back(avx2);
+#endif
+
+	// Any chroma offsets do for measuring the row functions
+	int16 *offsets = new int16[size.w * 3];
+	for (int i = 0; i < size.w * 3; ++i)
+		offsets[i] = (int16)(planes[i] - 128);
+
+	for (int f = kRGB565; f <= kARGB8888; ++f) {
+		const NamedFormat &format = formats[f];
+		Graphics::Surface dst;
+		dst.create(size.w, size.h, format.format);
+
+		runner.run(Common::String::format("yuv/444-%s-", format.name) + sizeName(size), "pixels", [&]() {
+			YUVToRGBMan.convert444(&dst, Graphics::YUVToRGBManager::kScaleFull, ySrc, uSrc, vSrc, size.w, size.h, size.w, size.w);
+			return pixels;
+		});
+
+		runner.run(Common::String::format("yuv/420-%s-", format.name) + sizeName(size), "pixels", [&]() {
+			YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleFull, ySrc, uSrc, vSrc, size.w, size.h, size.w, size.w / 2);
+			return pixels;
+		});
+
+		runner.run(Common::String::format("yuv/420-itu-%s-", format.name) + sizeName(size), "pixels", [&]() {
+			YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleITU, ySrc, uSrc, vSrc, size.w, size.h, size.w, size.w / 2);
+			return pixels;
+		});
+
+		runner.run(Common::String::format("yuv/420-alpha-%s-", format.name) + sizeName(size), "pixels", [&]() {
+			YUVToRGBMan.convert420Alpha(&dst, Graphics::YUVToRGBManager::kScaleFull, ySrc, uSrc, vSrc, aSrc, size.w, size.h, size.w, size.w / 2);
+			return pixels;
+		});
+
+		const Graphics::YUVToRGBRowParams params(format.format, false);
+		for (uint b = 0; b < rowBackends.size(); ++b) {
+			const Graphics::YUVToRGBRow::ConvertFunc convert = rowBackends[b].getConvertFunc(format.format.bytesPerPixel, true, false);
+
+			runner.run(Common::String::format("yuv-row/%s-%s-", rowBackends[b].name, format.name) + sizeName(size), "pixels", [&]() {
+				for (int y = 0; y < size.h; ++y)
+					convert((byte *)dst.getBasePtr(0, y), ySrc + y * size.w, aSrc, offsets, offsets + size.w, offsets + size.w * 2, size.w, params);
+				return pixels;
+			});
+		}
+
+		dst.free();
+	}
+
+	delete[] offsets;
+	delete[] planes;
+}
+
+/**
+ * createRenderer() uses the overlay format, which the null backend only has
+ * after initBackend(), so the renderers are created for each format here.
+ */
+Graphics::VectorRenderer *createRenderer(bool antialias, const Graphics::PixelFormat &format) {
+#ifndef DISABLE_FANCY_THEMES
+	if (antialias) {
+		if (format.bytesPerPixel == 4)
+			return new Graphics::VectorRendererAA<uint32>(format);
+		return new Graphics::VectorRendererAA<uint16>(format);
+	}
+#endif
+	if (format.bytesPerPixel == 4)
+		return new Graphics::VectorRendererSpec<uint32>(format);
+	return new Graphics::VectorRendererSpec<uint16>(format);
+}
+
+void benchVectorRenderer(Bench::Runner &runner, const NamedFormat (&formats)[kNumFormats]) {
+	static const char *const modeNames[] = { "standard", "antialias" };
+	static const Graphics::VectorRenderer::FillMode fillModes[] = { Graphics::VectorRenderer::kFillForeground, Graphics::VectorRenderer::kFillGradient };
+	static const char *const fillModeNames[] = { "fill", "gradient" };
+
+	// About the size of a dialog and of a button
+	static const Size shapeSizes[] = { { 400, 300 }, { 100, 20 } };
+
+	for (int i = 0; i < kNumFormats; ++i) {
+		// The themes draw to 16 and 32 bpp surfaces only
+		if (formats[i].format.bytesPerPixel != 2 && formats[i].format.bytesPerPixel != 4)
+			continue;
+
+		Graphics::ManagedSurface surface(640, 480, formats[i].format);
+
+		for (int m = 0; m < ARRAYSIZE(modeNames); ++m) {
+#ifdef DISABLE_FANCY_THEMES
+			if (m != 0) {
+				runner.skip(Common::String::format("vector/*-%s-%s", modeNames[m], formats[i].name), "fancy themes are disabled");
+				continue;
+			}
+#endif
+			Graphics::VectorRenderer *renderer = createRenderer(m != 0, formats[i].format);
+			renderer->setSurface(&surface);
+			renderer->setFgColor(200, 100, 50);
+			renderer->setBgColor(20, 40, 60);
+			renderer->setGradientColors(255, 0, 0, 0, 0, 255);
+			renderer->setStrokeWidth(1);
+			renderer->setShadowOffset(0);
+
+			for (int f = 0; f < ARRAYSIZE(fillModes); ++f) {
+				renderer->setFillMode(fillModes[f]);
+
+				for (int s = 0; s < ARRAYSIZE(shapeSizes); ++s) {
+					const Size &size = shapeSizes[s];
+					const uint64 pixels = (uint64)size.w * size.h;
+					const Common::String suffix = Common::String::format("-%s-%s-%s-", modeNames[m], fillModeNames[f], formats[i].name) + sizeName(size);
+
+					runner.run("vector/square" + suffix, "pixels", [&]() {
+						renderer->drawSquare(10, 10, size.w, size.h);
+						return pixels;
+					});
+
+					runner.run("vector/rounded" + suffix, "pixels", [&]() {
+						renderer->drawRoundedSquare(10, 10, 8, size.w, size.h);
+						return pixels;
+					});
+
+					runner.run("vector/beveled" + suffix, "pixels", [&]() {
+						renderer->drawBeveledSquare(10, 10, size.w, size.h);
+						return pixels;
+					});
+
+					// The themes draw triangles as arrows in square boxes only
+					const int side = MIN(size.w, size.h);
+					runner.run("vector/triangle" + suffix, "pixels", [&]() {
+						renderer->drawTriangle(10, 10, side, side, Graphics::VectorRenderer::kTriangleUp);
+						return (uint64)side * side;
+					});
+
+					const int r = side / 2;
+					runner.run("vector/circle" + suffix, "pixels", [&]() {
+						renderer->drawCircle(10 + r, 10 + r, r);
+						return (uint64)(4 * r * r);
+					});
+				}
+			}
+
+			delete renderer;
+		}
+	}
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	Bench::Runner runner("graphics", argc, argv);
+
+	Common::install_null_g_system(false);
+
+	runner.addInfo("sse2", g_system->hasFeature(OSystem::kFeatureCpuSSE2) ? "yes" : "no");
+	runner.addInfo("avx2", g_system->hasFeature(OSystem::kFeatureCpuAVX2) ? "yes" : "no");
+	runner.addInfo("neon", g_system->hasFeature(OSystem::kFeatureCpuNEON) ? "yes" : "no");
+
+	const Common::Array<Size> sizes = parseSizes(runner.getOption("sizes", "320x200,640x480,1280x720"));
+
+	NamedFormat formats[kNumFormats];
+	getFormats(formats);
+
+	for (uint i = 0; i < sizes.size(); ++i) {
+		benchBlits(runner, sizes[i], formats);
+		benchBlendBlit(runner, sizes[i]);
+		benchScalers(runner, sizes[i], formats);
+		benchYUV(runner, sizes[i], formats);
+	}
+	benchVectorRenderer(runner, formats);
+
+	return runner.finish();
+}
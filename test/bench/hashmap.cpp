@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Compares HashMap and FlatHashMap with integer and case insensitive string
+ * keys, at a size which fits into the caches and one which doesn't. Run it
+ * with "make bench-hashmap"; see test/bench/bench.h for the options.
+ */
+
+#include "test/bench/bench.h"
+#include "test/null_osystem.h"
+
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+
+namespace {
+
+/** Keys like those of the configuration or of archive members */
+Common::Array<Common::String> makeStringKeys(uint count, const char *prefix) {
+	Common::Array<Common::String> keys;
+	for (uint i = 0; i < count; ++i)
+		keys.push_back(Common::String::format("%s/Resource.%03u_%u", prefix, i % 1000, i * 7919));
+	return keys;
+}
+
+/** Sparse keys like selector IDs or object addresses */
+Common::Array<uint> makeIntKeys(uint count, uint offset) {
+	Common::Array<uint> keys;
+	for (uint i = 0; i < count; ++i)
+		keys.push_back((i + offset) * 24 + 0x1000);
+	return keys;
+}
+
+template<class Map, class Key>
+void benchMap(Bench::Runner &runner, const char *mapName, const char *keyName, const Common::Array<Key> &keys, const Common::Array<Key> &missingKeys) {
+	const Common::String prefix = Common::String::format("%s/%s-%u/", mapName, keyName, keys.size());
+
+	runner.run(prefix + "insert", "ops", [&]() {
+		Map map;
+		for (uint i = 0; i < keys.size(); ++i)
+			map[keys[i]] = i;
+		return (uint64)keys.size();
+	});
+
+	Map map;
+	for (uint i = 0; i < keys.size(); ++i)
+		map[keys[i]] = i;
+
+	uint64 sum = 0;
+
+	runner.run(prefix + "lookup-hit", "ops", [&]() {
+		for (uint i = 0; i < keys.size(); ++i)
+			sum += map.getVal(keys[i]);
+		return (uint64)keys.size();
+	});
+
+	runner.run(prefix + "lookup-miss", "ops", [&]() {
+		for (uint i = 0; i < missingKeys.size(); ++i)
+			sum += map.contains(missingKeys[i]);
+		return (uint64)missingKeys.size();
+	});
+
+	runner.run(prefix + "iterate", "ops", [&]() {
+		for (typename Map::const_iterator i = map.begin(); i != map.end(); ++i)
+			sum += i->_value;
+		return (uint64)map.size();
+	});
+
+	runner.run(prefix + "erase-insert", "ops", [&]() {
+		for (uint i = 0; i < keys.size(); ++i) {
+			map.erase(keys[i]);
+			map[keys[i]] = i;
+		}
+		return (uint64)keys.size();
+	});
+
+	// Keep the compiler from optimizing the lookups away
+	if (sum == 1)
+		runner.addInfo("unlikely", "");
+}
+
+void benchSize(Bench::Runner &runner, uint size) {
+	const Common::Array<uint> intKeys = makeIntKeys(size, 0);
+	const Common::Array<uint> missingIntKeys = makeIntKeys(size, size);
+	benchMap<Common::HashMap<uint, uint>, uint>(runner, "hashmap", "int", intKeys, missingIntKeys);
+	benchMap<Common::FlatHashMap<uint, uint>, uint>(runner, "flathashmap", "int", intKeys, missingIntKeys);
+
+	const Common::Array<Common::String> stringKeys = makeStringKeys(size, "data");
+	const Common::Array<Common::String> missingStringKeys = makeStringKeys(size, "DATA2");
+	benchMap<Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>, Common::String>(runner, "hashmap", "string", stringKeys, missingStringKeys);
+	benchMap<Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>, Common::String>(runner, "flathashmap", "string", stringKeys, missingStringKeys);
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	Bench::Runner runner("hashmap", argc, argv);
+
+	Common::install_null_g_system(false);
+
+	benchSize(runner, 100);
+	benchSize(runner, 100000);
+
+	return runner.finish();
+}
@@ -104,4 +104,23 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_borrow() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		ms.skip(1);
+		const byte *data = ms.borrow(4);
+		TS_ASSERT_EQUALS(data, contents + 1);
+		TS_ASSERT_EQUALS(ms.pos(), 5);
+
+		// Not enough data left: the position must not change
+		TS_ASSERT(!ms.borrow(3));
+		TS_ASSERT_EQUALS(ms.pos(), 5);
+		TS_ASSERT(!ms.eos());
+
+		data = ms.borrow(2);
+		TS_ASSERT_EQUALS(data, contents + 5);
+		TS_ASSERT_EQUALS(ms.pos(), 7);
+	}
 };
@@ -0,0 +1,77 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(POSIX) && defined(HAS_MMAP)
+#include "backends/fs/posix/posix-fs.h"
+#include "backends/fs/posix/posix-iostream.h"
+#endif
+
+// Uses the copy of encoding.dat in the build directory, which is big enough
+// to be mapped
+class PosixMappedStreamTestSuite : public CxxTest::TestSuite {
+	public:
+#if defined(POSIX) && defined(HAS_MMAP)
+	void test_not_a_file() {
+		TS_ASSERT(!PosixMappedStream::makeFromPath("test/engine-data"));
+		TS_ASSERT(!PosixMappedStream::makeFromPath("test/engine-data/missing.dat"));
+	}
+
+	void test_read_seek_borrow() {
+		PosixIoStream *file = PosixIoStream::makeFromPath("test/engine-data/encoding.dat", false);
+		PosixMappedStream *ms = PosixMappedStream::makeFromPath("test/engine-data/encoding.dat");
+		TS_ASSERT(file);
+		TS_ASSERT(ms);
+		if (!file || !ms) {
+			delete file;
+			delete ms;
+			return;
+		}
+
+		const int64 size = file->size();
+		TS_ASSERT_LESS_THAN_EQUALS(PosixMappedStream::kMinMappedSize, size);
+		TS_ASSERT_EQUALS(ms->size(), size);
+
+		byte expected[16], buffer[16];
+		file->read(expected, 16);
+		TS_ASSERT_EQUALS(ms->read(buffer, 16), 16u);
+		TS_ASSERT_SAME_DATA(buffer, expected, 16);
+
+		file->read(expected, 4);
+		const byte *data = ms->borrow(4);
+		TS_ASSERT(data);
+		TS_ASSERT_SAME_DATA(data, expected, 4);
+		TS_ASSERT_EQUALS(ms->pos(), 20);
+
+		// Not enough data left: the position must not change
+		TS_ASSERT(ms->seek(-2, SEEK_END));
+		TS_ASSERT(!ms->borrow(3));
+		TS_ASSERT_EQUALS(ms->pos(), size - 2);
+
+		file->seek(-2, SEEK_END);
+		file->read(expected, 2);
+		TS_ASSERT_EQUALS(ms->read(buffer, 16), 2u);
+		TS_ASSERT_SAME_DATA(buffer, expected, 2);
+		TS_ASSERT(ms->eos());
+
+		TS_ASSERT(!ms->seek(size + 1));
+		TS_ASSERT(ms->seek(100, SEEK_SET));
+		TS_ASSERT(!ms->eos());
+		file->seek(100, SEEK_SET);
+		TS_ASSERT_EQUALS(ms->readByte(), file->readByte());
+
+		delete ms;
+		delete file;
+	}
+
+	void test_node_maps_big_files() {
+		POSIXFilesystemNode node("test/engine-data/encoding.dat");
+		Common::SeekableReadStream *stream = node.createReadStream();
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		TS_ASSERT(stream->borrow(16));
+		TS_ASSERT_EQUALS(stream->pos(), 16);
+		delete stream;
+	}
+#endif
+};
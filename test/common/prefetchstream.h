@@ -0,0 +1,196 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bufferedstream.h"
+#include "common/memstream.h"
+#include "common/prefetch.h"
+#include "../null_osystem.h"
+
+namespace {
+
+/** A stream which claims to be huge, without any data behind it */
+class HugeReadStream : public Common::SeekableReadStream {
+public:
+	HugeReadStream() : _pos(0) {}
+
+	bool eos() const override { return false; }
+	uint32 read(void *dataPtr, uint32 dataSize) override { return 0; }
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return 64 * 1024 * 1024; }
+	bool seek(int64 offset, int whence = SEEK_SET) override { _pos = offset; return true; }
+
+private:
+	int64 _pos;
+};
+
+} // End of anonymous namespace
+
+// The streams use mutexes, which need an OSystem. Unless readAhead() is
+// called, all reading is done on demand.
+class PrefetchStreamTestSuite : public CxxTest::TestSuite {
+	public:
+#if NULL_OSYSTEM_IS_AVAILABLE
+	void test_traverse() {
+		Common::install_null_g_system();
+
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableReadStream &ssrs
+			= *Common::wrapPrefetchingSeekableReadStream(&ms, 4, DisposeAfterUse::NO);
+
+		byte i, b;
+		for (i = 0; i < 10; ++i) {
+			TS_ASSERT(!ssrs.eos());
+
+			TS_ASSERT_EQUALS(i, ssrs.pos());
+
+			ssrs.read(&b, 1);
+			TS_ASSERT_EQUALS(i, b);
+		}
+
+		TS_ASSERT(!ssrs.eos());
+
+		TS_ASSERT_EQUALS((uint)0, ssrs.read(&b, 1));
+		TS_ASSERT(ssrs.eos());
+
+		delete &ssrs;
+	}
+
+	void test_seek_read() {
+		Common::install_null_g_system();
+
+		byte contents[100];
+		for (int i = 0; i < 100; ++i)
+			contents[i] = i;
+		Common::MemoryReadStream ms(contents, 100);
+
+		Common::SeekableReadStream &ssrs
+			= *Common::wrapPrefetchingSeekableReadStream(&ms, 16, DisposeAfterUse::NO);
+		byte buffer[40];
+
+		// Wraps around in the buffer
+		TS_ASSERT_EQUALS(ssrs.read(buffer, 10), 10u);
+		TS_ASSERT_EQUALS(ssrs.read(buffer, 10), 10u);
+		TS_ASSERT_EQUALS(buffer[0], 10);
+		TS_ASSERT_EQUALS(buffer[9], 19);
+
+		// Within the buffered data
+		TS_ASSERT(ssrs.seek(3, SEEK_CUR));
+		TS_ASSERT_EQUALS(ssrs.pos(), 23);
+		TS_ASSERT_EQUALS(ssrs.readByte(), 23);
+
+		// Backwards, and a read bigger than the buffer
+		TS_ASSERT(ssrs.seek(5, SEEK_SET));
+		TS_ASSERT_EQUALS(ssrs.read(buffer, 40), 40u);
+		TS_ASSERT_EQUALS(buffer[0], 5);
+		TS_ASSERT_EQUALS(buffer[39], 44);
+		TS_ASSERT_EQUALS(ssrs.pos(), 45);
+
+		TS_ASSERT(ssrs.seek(-4, SEEK_END));
+		TS_ASSERT_EQUALS(ssrs.read(buffer, 10), 4u);
+		TS_ASSERT_EQUALS(buffer[3], 99);
+		TS_ASSERT(ssrs.eos());
+
+		TS_ASSERT(!ssrs.seek(101, SEEK_SET));
+		TS_ASSERT(ssrs.seek(0, SEEK_SET));
+		TS_ASSERT(!ssrs.eos());
+		TS_ASSERT_EQUALS(ssrs.readByte(), 0);
+
+		delete &ssrs;
+	}
+
+	void test_read_ahead() {
+		Common::install_null_g_system();
+
+		byte contents[100];
+		for (int i = 0; i < 100; ++i)
+			contents[i] = i;
+		Common::MemoryReadStream ms(contents, 100);
+
+		Common::SeekableReadStream &ssrs
+			= *Common::wrapPrefetchingSeekableReadStream(&ms, 16, DisposeAfterUse::NO);
+
+		// Fills the buffer, and then has nothing left to do
+		TS_ASSERT(Common::readAhead());
+		TS_ASSERT(!Common::readAhead());
+		TS_ASSERT_EQUALS(ms.pos(), 16);
+
+		// Reads within the buffered data don't touch the parent stream
+		byte buffer[10];
+		TS_ASSERT_EQUALS(ssrs.read(buffer, 10), 10u);
+		TS_ASSERT_EQUALS(buffer[9], 9);
+		TS_ASSERT_EQUALS(ms.pos(), 16);
+
+		// The limit is respected
+		TS_ASSERT(Common::readAhead(4));
+		TS_ASSERT_EQUALS(ms.pos(), 20);
+		TS_ASSERT(Common::readAhead());
+		TS_ASSERT_EQUALS(ms.pos(), 26);
+
+		TS_ASSERT_EQUALS(ssrs.read(buffer, 10), 10u);
+		TS_ASSERT_EQUALS(buffer[0], 10);
+		TS_ASSERT_EQUALS(buffer[9], 19);
+
+		delete &ssrs;
+		TS_ASSERT(!Common::readAhead());
+
+		// Whole files are read into memory as well
+		Common::SeekableReadStream *buffered = Common::wrapBufferedSeekableReadStream(new Common::MemoryReadStream(contents, 100), 4, DisposeAfterUse::YES);
+		Common::AsyncReadHandle handle(buffered, true);
+		TS_ASSERT(!handle.isReady());
+		while (Common::readAhead())
+			;
+		TS_ASSERT(handle.isReady());
+
+		Common::SeekableReadStream *stream = handle.getStream();
+		TS_ASSERT_EQUALS(stream->size(), 100);
+		stream->seek(42);
+		TS_ASSERT_EQUALS(stream->readByte(), 42);
+		delete stream;
+	}
+
+	void test_async_read() {
+		Common::install_null_g_system();
+
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+		// A memory stream lends its data, so it is passed on as it is
+		Common::SeekableReadStream *ms = new Common::MemoryReadStream(contents, 10);
+		Common::AsyncReadHandle handle(ms, true);
+		TS_ASSERT(handle.isValid());
+
+		Common::SeekableReadStream *stream = handle.getStream();
+		TS_ASSERT_EQUALS(stream, ms);
+		TS_ASSERT_EQUALS(stream->pos(), 0);
+		TS_ASSERT(!handle.getStream());
+		delete stream;
+
+		// Other streams are read into memory
+		Common::SeekableReadStream *buffered = Common::wrapBufferedSeekableReadStream(new Common::MemoryReadStream(contents, 10), 4, DisposeAfterUse::YES);
+		Common::AsyncReadHandle copy;
+		{
+			Common::AsyncReadHandle handle2(buffered, true);
+			copy = handle2;
+		}
+
+		stream = copy.getStream();
+		TS_ASSERT_DIFFERS(stream, buffered);
+		TS_ASSERT(copy.isReady());
+		TS_ASSERT_EQUALS(stream->size(), 10);
+		stream->seek(7);
+		TS_ASSERT_EQUALS(stream->readByte(), 7);
+		delete stream;
+
+		// Too big to be held in memory, so it is passed on as well
+		Common::SeekableReadStream *huge = new HugeReadStream();
+		Common::AsyncReadHandle hugeHandle(huge, true);
+		TS_ASSERT(hugeHandle.isReady());
+		TS_ASSERT_EQUALS(hugeHandle.getStream(), huge);
+		delete huge;
+
+		Common::AsyncReadHandle invalid(nullptr, true);
+		TS_ASSERT(!invalid.isValid());
+		TS_ASSERT(!invalid.getStream());
+	}
+#endif
+};
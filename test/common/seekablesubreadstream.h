@@ -70,4 +70,29 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_borrow() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SafeSeekableSubReadStream ssrs1(&ms, 1, 9);
+		Common::SafeSeekableSubReadStream ssrs2(&ms, 4, 6);
+
+		const byte *data = ssrs1.borrow(3);
+		TS_ASSERT_EQUALS(data, contents + 1);
+		TS_ASSERT_EQUALS(ssrs1.pos(), 3);
+
+		data = ssrs2.borrow(2);
+		TS_ASSERT_EQUALS(data, contents + 4);
+		TS_ASSERT_EQUALS(ssrs2.pos(), 2);
+
+		// The parent has more data, but the substream ends before it
+		TS_ASSERT(!ssrs1.borrow(6));
+		TS_ASSERT_EQUALS(ssrs1.pos(), 3);
+
+		data = ssrs1.borrow(5);
+		TS_ASSERT_EQUALS(data, contents + 4);
+		TS_ASSERT_EQUALS(ssrs1.pos(), 8);
+		TS_ASSERT(!ssrs1.eos());
+	}
 };
@@ -0,0 +1,107 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/smallalloc.h"
+
+class SmallAllocTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_small_alloc() {
+		// Fill blocks of all size classes and some big ones with a pattern
+		byte *blocks[300];
+		for (uint i = 0; i < 300; ++i) {
+			blocks[i] = (byte *)Common::allocSmall(i + 1);
+			TS_ASSERT(blocks[i]);
+			TS_ASSERT_EQUALS((uintptr)blocks[i] % (i + 1 >= 16 ? alignof(max_align_t) : 8), 0u);
+			memset(blocks[i], i & 0xFF, i + 1);
+		}
+
+		for (uint i = 0; i < 300; ++i) {
+			for (uint j = 0; j <= i; ++j) {
+				if (blocks[i][j] != (i & 0xFF)) {
+					TS_FAIL("Blocks overlap");
+					break;
+				}
+			}
+		}
+
+		for (uint i = 0; i < 300; ++i)
+			Common::freeSmall(blocks[i], i + 1);
+
+		// Freed blocks are reused
+		void *first = Common::allocSmall(24);
+		Common::freeSmall(first, 24);
+		void *second = Common::allocSmall(20);
+		TS_ASSERT_EQUALS(first, second);
+		Common::freeSmall(second, 20);
+
+		Common::freeSmall(nullptr, 8);
+	}
+
+	void test_small_alloc_churn() {
+		// More blocks than a thread cache keeps, freed in a different order
+		void *blocks[1000];
+		for (uint round = 0; round < 3; ++round) {
+			for (uint i = 0; i < 1000; ++i) {
+				blocks[i] = Common::allocSmall(16);
+				*(uint32 *)blocks[i] = i;
+			}
+			for (uint i = 0; i < 1000; ++i)
+				TS_ASSERT_EQUALS(*(uint32 *)blocks[i], i);
+			for (uint i = 0; i < 1000; i += 2)
+				Common::freeSmall(blocks[i], 16);
+			for (uint i = 1; i < 1000; i += 2)
+				Common::freeSmall(blocks[i], 16);
+		}
+	}
+
+	void test_stats() {
+		Common::SmallAllocStats before, during, after;
+		Common::getSmallAllocStats(before);
+
+		void *blocks[100];
+		for (uint i = 0; i < 100; ++i)
+			blocks[i] = Common::allocSmall(40);
+		void *big = Common::allocSmall(1000);
+
+		Common::getSmallAllocStats(during);
+
+#ifdef SCUMMVM_SMALL_ALLOC
+		TS_ASSERT_EQUALS(during.sizeClasses[3].size, 48u);
+		TS_ASSERT_EQUALS(during.sizeClasses[3].allocations - before.sizeClasses[3].allocations, 100u);
+		TS_ASSERT_EQUALS(during.sizeClasses[3].live - before.sizeClasses[3].live, 100u);
+		TS_ASSERT_EQUALS(during.largeAllocations - before.largeAllocations, 1u);
+		TS_ASSERT_EQUALS(during.bytesLive - before.bytesLive, 100u * 48 + 1000);
+		TS_ASSERT_LESS_THAN_EQUALS(during.bytesLive, during.bytesPeak);
+		TS_ASSERT_LESS_THAN_EQUALS(during.sizeClasses[3].cacheHits, during.sizeClasses[3].allocations);
+#endif
+
+		for (uint i = 0; i < 100; ++i)
+			Common::freeSmall(blocks[i], 40);
+		Common::freeSmall(big, 1000);
+
+		Common::getSmallAllocStats(after);
+		TS_ASSERT_EQUALS(after.sizeClasses[3].live, before.sizeClasses[3].live);
+		TS_ASSERT_EQUALS(after.bytesLive, before.bytesLive);
+	}
+
+	void test_release_pages() {
+#ifdef SCUMMVM_SMALL_ALLOC
+		// Enough blocks of the biggest class to fill about 16 pages
+		void *blocks[1000];
+		Common::SmallAllocStats before, during, after;
+		Common::getSmallAllocStats(before);
+
+		for (uint i = 0; i < 1000; ++i)
+			blocks[i] = Common::allocSmall(250);
+		Common::getSmallAllocStats(during);
+		TS_ASSERT_LESS_THAN_EQUALS(before.bytesReserved + 15 * Common::kSmallAllocPageSize, during.bytesReserved);
+
+		for (uint i = 0; i < 1000; ++i)
+			Common::freeSmall(blocks[i], 250);
+		Common::getSmallAllocStats(after);
+
+		// Only the pages of the blocks in the thread cache, and one empty
+		// page, are kept
+		TS_ASSERT_LESS_THAN_EQUALS(after.bytesReserved, before.bytesReserved + 3 * Common::kSmallAllocPageSize);
+#endif
+	}
+};
@@ -0,0 +1,53 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler/hq_intern.h"
+
+#include "../null_osystem.h"
+
+class HQScalerTestSuite : public CxxTest::TestSuite {
+#if defined(USE_HQ_SCALERS) && NULL_OSYSTEM_IS_AVAILABLE
+public:
+	// Every SIMD implementation the CPU supports, not only the fastest one
+	void test_pattern_functions() {
+		Common::install_null_g_system();
+
+		Common::Array<HQPatterns::PatternFunc> impls;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) impls.push_back(HQPatterns::getPatternFuncNEON());
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) impls.push_back(HQPatterns::getPatternFuncSSE2());
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) impls.push_back(HQPatterns::getPatternFuncAVX2());
+#endif
+
+		// Not a multiple of the vector sizes, to cover the tails
+		const int width = 45;
+		uint32 yuv[3][width + 2];
+
+		// Differences around the thresholds of all three components
+		const int ySteps[] = { 0, 0x17, 0x18, 0x19, 0x30, 0x31 };
+		const int uvSteps[] = { 0, 3, 4, 6, 7, 8 };
+		uint32 seed = 12345;
+		for (int row = 0; row < 3; row++) {
+			for (int x = 0; x < width + 2; x++) {
+				seed = seed * 1103515245 + 12345;
+				const int y = 0x40 + ySteps[(seed >> 8) % ARRAYSIZE(ySteps)];
+				const int u = 0x80 + uvSteps[(seed >> 12) % ARRAYSIZE(uvSteps)];
+				const int v = 0x80 - uvSteps[(seed >> 16) % ARRAYSIZE(uvSteps)];
+				yuv[row][x] = (y << 16) | (u << 8) | v;
+			}
+		}
+
+		byte expected[width], actual[width];
+		HQPatterns::computeGeneric(expected, yuv[0] + 1, yuv[1] + 1, yuv[2] + 1, 0, width);
+
+		for (uint i = 0; i < impls.size(); i++) {
+			memset(actual, 0xCD, sizeof(actual));
+			impls[i](actual, yuv[0] + 1, yuv[1] + 1, yuv[2] + 1, width);
+			TS_ASSERT_SAME_DATA(expected, actual, width);
+		}
+	}
+#endif
+};
@@ -0,0 +1,119 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include "../null_osystem.h"
+
+class TinyGLTestSuite : public CxxTest::TestSuite {
+#if defined(USE_TINYGL) && NULL_OSYSTEM_IS_AVAILABLE
+public:
+	// A rotated blit covers more than its destination rectangle, all of which
+	// has to be redrawn once it is gone
+	void test_rotated_blit_dirty_region() {
+		Common::install_null_g_system();
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		TinyGL::ContextHandle *context = TinyGL::createContext(100, 90, format, 256, false, true);
+
+		Graphics::Surface imageSurface;
+		imageSurface.create(16, 40, format);
+		imageSurface.fillRect(Common::Rect(16, 40), format.ARGBToColor(255, 255, 255, 255));
+		TinyGL::BlitImage *image = tglGenBlitImage();
+		tglUploadBlitImage(image, imageSurface, 0, false);
+		imageSurface.free();
+
+		for (int frame = 0; frame < 2; frame++) {
+			tglClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+			tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+			if (frame == 0) {
+				TinyGL::BlitTransform transform(40, 20);
+				transform.rotate(45, 8, 20);
+				tglBlit(image, transform);
+			}
+			TinyGL::presentBuffer();
+		}
+
+		Graphics::Surface *result = TinyGL::copyFromFrameBuffer(format);
+		const uint32 black = format.ARGBToColor(255, 0, 0, 0);
+		int leftovers = 0;
+		for (int y = 0; y < result->h; y++)
+			for (int x = 0; x < result->w; x++)
+				leftovers += *(const uint32 *)result->getBasePtr(x, y) != black;
+		TS_ASSERT_EQUALS(leftovers, 0);
+
+		result->free();
+		delete result;
+		tglDeleteBlitImage(image);
+		TinyGL::destroyContext(context);
+	}
+
+	// Every SIMD implementation the CPU supports, not only the fastest one
+	void test_span_functions() {
+		Common::install_null_g_system();
+
+		Common::Array<TinyGL::Span::FillFunc (*)(int, bool)> impls;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) impls.push_back(&TinyGL::Span::getFillFuncNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) impls.push_back(&TinyGL::Span::getFillFuncSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) impls.push_back(&TinyGL::Span::getFillFuncAVX2);
+#endif
+
+		const TGLenum depthFuncs[] = { TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL, TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS };
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 8, 16, 24, 0)
+		};
+
+		// Not a multiple of the vector sizes, to cover the tails
+		const int count = 45;
+		uint32 pixels[2][count];
+		uint zbuf[2][count];
+
+		TinyGL::SpanInterpolants start;
+		start.z = 0x3FFFFFF0;
+		start.dzdx = -0x00123457;
+		start.r = 0x1234;
+		start.g = 0xFF00;
+		start.b = 0x80;
+		start.a = 0xFFFF;
+		start.drdx = 0x321;
+		start.dgdx = -0x1FF;
+		start.dbdx = 0x7FF;
+		start.dadx = -0x100;
+
+		for (uint i = 0; i < impls.size(); i++) {
+			for (int mode = 0; mode < 3; mode++) {
+				for (int depthWrite = 0; depthWrite < 2; depthWrite++) {
+					TinyGL::Span::FillFunc fill = impls[i](mode, depthWrite);
+					for (int f = 0; f < ARRAYSIZE(depthFuncs); f++) {
+						const TinyGL::SpanParams params(formats[f & 1], f != 0, depthFuncs[f]);
+
+						// The depth of every other pixel equals the one of the span
+						for (int x = 0; x < count; x++) {
+							pixels[0][x] = pixels[1][x] = 0xDEADBEEF + x;
+							zbuf[0][x] = zbuf[1][x] = (x & 1) ? start.z + x * start.dzdx : 0x1F000000 + x * 0x00300001;
+						}
+
+						if (mode == 0)
+							depthWrite ? TinyGL::Span::fillGeneric<false, false, true>(pixels[0], zbuf[0], 0, count, start, params) : TinyGL::Span::fillGeneric<false, false, false>(pixels[0], zbuf[0], 0, count, start, params);
+						else if (mode == 1)
+							depthWrite ? TinyGL::Span::fillGeneric<true, false, true>(pixels[0], zbuf[0], 0, count, start, params) : TinyGL::Span::fillGeneric<true, false, false>(pixels[0], zbuf[0], 0, count, start, params);
+						else
+							depthWrite ? TinyGL::Span::fillGeneric<true, true, true>(pixels[0], zbuf[0], 0, count, start, params) : TinyGL::Span::fillGeneric<true, true, false>(pixels[0], zbuf[0], 0, count, start, params);
+						fill(pixels[1], zbuf[1], count, start, params);
+
+						TS_ASSERT_SAME_DATA(pixels[0], pixels[1], sizeof(pixels[0]));
+						TS_ASSERT_SAME_DATA(zbuf[0], zbuf[1], sizeof(zbuf[0]));
+					}
+				}
+			}
+		}
+	}
+#endif
+};
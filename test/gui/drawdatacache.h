@@ -0,0 +1,128 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/VectorRendererSpec.h"
+#include "gui/DrawDataCache.h"
+
+class DrawDataCacheTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 160,
+		kHeight = 120
+	};
+
+	// Stripes repeating every 8 rows, so that items drawn 8 rows apart are
+	// drawn over the same background
+	static void fillBackground(Graphics::ManagedSurface &surface) {
+		for (int y = 0; y < surface.h; y++)
+			surface.hLine(0, y, surface.w - 1, surface.format.RGBToColor(40 + (y % 8) * 20, 90, 160 - (y % 8) * 10));
+	}
+
+	static Graphics::DrawStep::Color color(uint8 r, uint8 g, uint8 b) {
+		Graphics::DrawStep::Color c;
+		c.r = r;
+		c.g = g;
+		c.b = b;
+		c.set = true;
+		return c;
+	}
+
+	// A shaded, rounded button with a beveled frame
+	static Common::List<Graphics::DrawStep> buttonSteps() {
+		Common::List<Graphics::DrawStep> steps;
+
+		Graphics::DrawStep button;
+		button.drawingCall = &Graphics::VectorRenderer::drawCallback_ROUNDSQ;
+		button.autoWidth = button.autoHeight = true;
+		button.radius = 5;
+		button.shadow = 3;
+		button.stroke = 1;
+		button.factor = 1;
+		button.fillMode = Graphics::VectorRenderer::kFillGradient;
+		button.fgColor = color(20, 20, 20);
+		button.gradColor1 = color(250, 200, 60);
+		button.gradColor2 = color(200, 80, 0);
+		steps.push_back(button);
+
+		Graphics::DrawStep frame;
+		frame.drawingCall = &Graphics::VectorRenderer::drawCallback_BEVELSQ;
+		frame.autoWidth = frame.autoHeight = true;
+		frame.padding = Common::Rect(4, 4, 4, 4);
+		frame.bevel = 2;
+		frame.fillMode = Graphics::VectorRenderer::kFillDisabled;
+		frame.fgColor = color(255, 255, 255);
+		frame.bevelColor = color(60, 60, 60);
+		steps.push_back(frame);
+
+		return steps;
+	}
+
+	static bool sameSurfaces(const Graphics::ManagedSurface &a, const Graphics::ManagedSurface &b) {
+		for (int y = 0; y < a.h; y++) {
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), a.w * a.format.bytesPerPixel))
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void test_cached_rendering() {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const Common::List<Graphics::DrawStep> steps = buttonSteps();
+		const Common::Rect clip(kWidth, kHeight);
+
+		// The rect marked as dirty covers the shadow, as the theme engine's
+		// extended rect does
+		const Common::Rect areas[] = { Common::Rect(20, 16, 80, 40), Common::Rect(70, 64, 130, 88) };
+		Common::Rect rects[ARRAYSIZE(areas)];
+		for (int i = 0; i < ARRAYSIZE(areas); i++) {
+			rects[i] = areas[i];
+			rects[i].grow(GUI::ThemeEngine::kDirtyRectangleThreshold);
+			rects[i].right += 3;
+			rects[i].bottom += 3;
+			rects[i].left = MIN<int16>(rects[i].left, areas[i].left - 2);
+			rects[i].bottom++;
+			rects[i].clip(clip);
+		}
+
+		// A dirty rect which misses the shadow: never cached
+		const Common::Rect smallArea(20, 90, 60, 110);
+
+		Graphics::ManagedSurface uncached(kWidth, kHeight, format), cached(kWidth, kHeight, format);
+		Graphics::VectorRendererSpec<uint32> uncachedRenderer(format), cachedRenderer(format);
+		uncachedRenderer.setSurface(&uncached);
+		cachedRenderer.setSurface(&cached);
+
+		GUI::DrawDataCache cache;
+		cache.reset(kWidth * kHeight * 2);
+
+		// The steps inherit the renderer state the previous item left, so the
+		// renderings are only used from the second round on
+		for (int round = 0; round < 3; round++) {
+			fillBackground(uncached);
+			fillBackground(cached);
+
+			for (int i = 0; i < ARRAYSIZE(areas); i++) {
+				for (Common::List<Graphics::DrawStep>::const_iterator step = steps.begin(); step != steps.end(); ++step)
+					uncachedRenderer.drawStep(areas[i], clip, *step);
+				const bool hit = cache.drawSteps(&cachedRenderer, GUI::kDDButtonIdle, steps, areas[i], rects[i], clip, 0);
+				if (round == 0 && i == 0)
+					TS_ASSERT(!hit);
+				if (round == 2)
+					TS_ASSERT(hit);
+			}
+
+			for (Common::List<Graphics::DrawStep>::const_iterator step = steps.begin(); step != steps.end(); ++step)
+				uncachedRenderer.drawStep(smallArea, clip, *step);
+			TS_ASSERT(!cache.drawSteps(&cachedRenderer, GUI::kDDButtonIdle, steps, smallArea, smallArea, clip, 0));
+
+			TS_ASSERT(sameSurfaces(uncached, cached));
+		}
+
+		// Over a different background
+		uncached.fillRect(clip, format.RGBToColor(0, 0, 0));
+		cached.fillRect(clip, format.RGBToColor(0, 0, 0));
+		for (Common::List<Graphics::DrawStep>::const_iterator step = steps.begin(); step != steps.end(); ++step)
+			uncachedRenderer.drawStep(areas[0], clip, *step);
+		TS_ASSERT(!cache.drawSteps(&cachedRenderer, GUI::kDDButtonIdle, steps, areas[0], rects[0], clip, 0));
+		TS_ASSERT(sameSurfaces(uncached, cached));
+	}
+};
@@ -0,0 +1,207 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include "../null_osystem.h"
+
+namespace {
+
+/** The conversion of the mpeg_play derived lookup tables, one pixel at a time */
+uint32 referencePixel(const Graphics::PixelFormat &format, bool itu, int y, int u, int v, int a) {
+	int CR = v - 128, CB = u - 128;
+	int r = y + (int16)((0.419 / 0.299) * CR);
+	int g = y + (int16)(-(0.299 / 0.419) * CR) + (int16)(-(0.114 / 0.331) * CB);
+	int b = y + (int16)((0.587 / 0.331) * CB);
+
+	if (itu) {
+		r = (CLIP(r, 16, 235) - 16) * 255 / 219;
+		g = (CLIP(g, 16, 235) - 16) * 255 / 219;
+		b = (CLIP(b, 16, 235) - 16) * 255 / 219;
+	} else {
+		r = CLIP(r, 0, 255);
+		g = CLIP(g, 0, 255);
+		b = CLIP(b, 0, 255);
+	}
+
+	uint32 pixel = ((r >> format.rLoss) << format.rShift) | ((g >> format.gLoss) << format.gShift) | ((b >> format.bLoss) << format.bShift);
+	pixel |= ((a >> format.aLoss) << format.aShift);
+	return format.bytesPerPixel == 2 ? (uint16)pixel : pixel;
+}
+
+uint32 getPixel(const Graphics::Surface &surface, int x, int y) {
+	if (surface.format.bytesPerPixel == 2)
+		return *(const uint16 *)surface.getBasePtr(x, y);
+	return *(const uint32 *)surface.getBasePtr(x, y);
+}
+
+struct YUVImage {
+	enum {
+		// Not a multiple of the vector sizes, to cover the tails
+		kWidth = 52,
+		kHeight = 8,
+		kPitch = 64
+	};
+
+	byte y[kPitch * kHeight];
+	byte u[kPitch * kHeight];
+	byte v[kPitch * kHeight];
+	byte a[kPitch * kHeight];
+
+	YUVImage() {
+		// Include the extremes, which need to be clipped
+		uint32 seed = 12345;
+		for (int i = 0; i < kPitch * kHeight; i++) {
+			seed = seed * 1103515245 + 12345;
+			y[i] = (i % 7 == 0) ? 255 : (i % 11 == 0) ? 0 : (seed >> 16) & 0xFF;
+			u[i] = (i % 5 == 0) ? 0 : (seed >> 8) & 0xFF;
+			v[i] = (i % 3 == 0) ? 255 : (seed >> 24) & 0xFF;
+			a[i] = (seed >> 4) & 0xFF;
+		}
+	}
+};
+
+struct GenericImpl {
+	template<typename PixelInt, bool halfChroma, bool alpha>
+	static void convert(byte *dst, const byte *ySrc, const byte *aSrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const Graphics::YUVToRGBRowParams &params) {
+		Graphics::YUVToRGBRow::convertGeneric<PixelInt, halfChroma, alpha>(dst, ySrc, aSrc, rOffsets, gOffsets, bOffsets, 0, width, params);
+	}
+};
+
+Graphics::YUVToRGBRow::ConvertFunc getGeneric(uint bytesPerPixel, bool halfChroma, bool alpha) {
+	return Graphics::YUVToRGBRow::selectConvertFunc<GenericImpl>(bytesPerPixel, halfChroma, alpha);
+}
+
+} // End of anonymous namespace
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	Graphics::PixelFormat _formats[4];
+
+public:
+	YUVToRGBTestSuite() {
+		_formats[0] = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		_formats[1] = Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0);
+		_formats[2] = Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		_formats[3] = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+	}
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+	void test_convert() {
+		Common::install_null_g_system();
+
+		YUVImage image;
+		const int w = YUVImage::kWidth, h = YUVImage::kHeight, pitch = YUVImage::kPitch;
+
+		for (int f = 0; f < ARRAYSIZE(_formats); f++) {
+			const Graphics::PixelFormat &format = _formats[f];
+			const int opaque = 0xFF;
+
+			for (int scale = 0; scale < 2; scale++) {
+				const Graphics::YUVToRGBManager::LuminanceScale lumScale = scale ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+				Graphics::Surface surface;
+				surface.create(w, h, format);
+
+				YUVToRGBMan.convert444(&surface, lumScale, image.y, image.u, image.v, w, h, pitch, pitch);
+				for (int yy = 0; yy < h; yy++)
+					for (int x = 0; x < w; x++)
+						TS_ASSERT_EQUALS(getPixel(surface, x, yy), referencePixel(format, scale, image.y[yy * pitch + x], image.u[yy * pitch + x], image.v[yy * pitch + x], opaque));
+
+				YUVToRGBMan.convert422(&surface, lumScale, image.y, image.u, image.v, w, h, pitch, pitch);
+				for (int yy = 0; yy < h; yy++)
+					for (int x = 0; x < w; x++)
+						TS_ASSERT_EQUALS(getPixel(surface, x, yy), referencePixel(format, scale, image.y[yy * pitch + x], image.u[yy * pitch + x / 2], image.v[yy * pitch + x / 2], opaque));
+
+				YUVToRGBMan.convert420(&surface, lumScale, image.y, image.u, image.v, w, h, pitch, pitch);
+				for (int yy = 0; yy < h; yy++)
+					for (int x = 0; x < w; x++)
+						TS_ASSERT_EQUALS(getPixel(surface, x, yy), referencePixel(format, scale, image.y[yy * pitch + x], image.u[yy / 2 * pitch + x / 2], image.v[yy / 2 * pitch + x / 2], opaque));
+
+				YUVToRGBMan.convert420Alpha(&surface, lumScale, image.y, image.u, image.v, image.a, w, h, pitch, pitch);
+				for (int yy = 0; yy < h; yy++)
+					for (int x = 0; x < w; x++)
+						TS_ASSERT_EQUALS(getPixel(surface, x, yy), referencePixel(format, scale, image.y[yy * pitch + x], image.u[yy / 2 * pitch + x / 2], image.v[yy / 2 * pitch + x / 2], image.a[yy * pitch + x]));
+
+				surface.free();
+			}
+		}
+	}
+
+	void test_convert410() {
+		Common::install_null_g_system();
+
+		YUVImage image;
+		const int w = 36, h = 8, pitch = YUVImage::kPitch;
+
+		for (int f = 0; f < ARRAYSIZE(_formats); f++) {
+			const Graphics::PixelFormat &format = _formats[f];
+			Graphics::Surface surface;
+			surface.create(w, h, format);
+
+			YUVToRGBMan.convert410(&surface, Graphics::YUVToRGBManager::kScaleFull, image.y, image.u, image.v, w, h, pitch, pitch);
+
+			for (int yy = 0; yy < h; yy++) {
+				for (int x = 0; x < w; x++) {
+					// Bilinear interpolation of the chroma
+					const int index = (yy / 4) * pitch + x / 4;
+					const int xDiff = x & 3, yDiff = yy & 3;
+					int u = (image.u[index] * (4 - xDiff) * (4 - yDiff) + image.u[index + 1] * xDiff * (4 - yDiff) +
+						image.u[index + pitch] * yDiff * (4 - xDiff) + image.u[index + pitch + 1] * xDiff * yDiff) >> 4;
+					int v = (image.v[index] * (4 - xDiff) * (4 - yDiff) + image.v[index + 1] * xDiff * (4 - yDiff) +
+						image.v[index + pitch] * yDiff * (4 - xDiff) + image.v[index + pitch + 1] * xDiff * yDiff) >> 4;
+					TS_ASSERT_EQUALS(getPixel(surface, x, yy), referencePixel(format, false, image.y[yy * pitch + x], u, v, 0xFF));
+				}
+			}
+
+			surface.free();
+		}
+	}
+
+	// Every SIMD implementation the CPU supports, not only the fastest one
+	void test_row_functions() {
+		Common::install_null_g_system();
+
+		Common::Array<Graphics::YUVToRGBRow::ConvertFunc (*)(uint, bool, bool)> impls;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) impls.push_back(&Graphics::YUVToRGBRow::getConvertFuncNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) impls.push_back(&Graphics::YUVToRGBRow::getConvertFuncSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) impls.push_back(&Graphics::YUVToRGBRow::getConvertFuncAVX2);
+#endif
+
+		YUVImage image;
+		int16 offsets[3][YUVImage::kWidth];
+		for (int i = 0; i < YUVImage::kWidth; i++) {
+			offsets[0][i] = (int16)image.u[i] - 128 * 2;
+			offsets[1][i] = (int16)image.v[i] - 128;
+			offsets[2][i] = 200 - (int16)image.a[i];
+		}
+
+		uint32 expected[YUVImage::kWidth], actual[YUVImage::kWidth];
+
+		for (uint i = 0; i < impls.size(); i++) {
+			for (int f = 0; f < ARRAYSIZE(_formats); f++) {
+				for (int variant = 0; variant < 8; variant++) {
+					const bool halfChroma = variant & 1, alpha = variant & 2, itu = variant & 4;
+					const Graphics::YUVToRGBRowParams params(_formats[f], itu);
+
+					Graphics::YUVToRGBRow::ConvertFunc convert = impls[i](_formats[f].bytesPerPixel, halfChroma, alpha);
+					Graphics::YUVToRGBRow::ConvertFunc reference = getGeneric(_formats[f].bytesPerPixel, halfChroma, alpha);
+
+					reference((byte *)expected, image.y, image.a, offsets[0], offsets[1], offsets[2], YUVImage::kWidth, params);
+					convert((byte *)actual, image.y, image.a, offsets[0], offsets[1], offsets[2], YUVImage::kWidth, params);
+					TS_ASSERT_SAME_DATA(expected, actual, YUVImage::kWidth * _formats[f].bytesPerPixel);
+				}
+			}
+		}
+	}
+#endif
+
+	void test_itu_scale() {
+		for (int s = 0; s <= 219; s++)
+			TS_ASSERT_EQUALS(s + ((s * Graphics::YUVToRGBRow::kITUScale) >> 16), s * 255 / 219);
+	}
+};
@@ -2,19 +2,75 @@
 #define NULL_DRIVER_USE_FOR_TEST 1
 #include "null_osystem.h"
 #include "../backends/platform/null/null.cpp"
+#include "../backends/mixer/mixer.h"
 
 //#define DISPLAY_ERROR_MESSAGES
 
-void Common::install_null_g_system() {
+void Common::install_null_g_system(bool silenceLogs) {
 #ifdef DISPLAY_ERROR_MESSAGES
-	const bool silenceLogs = false;
-#else
-	const bool silenceLogs = true;
+	silenceLogs = false;
 #endif
 
 	g_system = OSystem_NULL_create(silenceLogs);
 }
 
+class TestMixerManager : public MixerManager {
+public:
+	TestMixerManager(uint outputRate) : _outputRate(outputRate) {}
+
+	void init() override {
+		_mixer = new Audio::MixerImpl(_outputRate, true, 1024);
+		_mixer->setReady(true);
+	}
+
+	void suspendAudio() override {
+		_audioSuspended = true;
+	}
+
+	int resumeAudio() override {
+		if (!_audioSuspended)
+			return -2;
+		_audioSuspended = false;
+		return 0;
+	}
+
+	Audio::MixerImpl *getMixerImpl() {
+		if (!_mixer)
+			init();
+		return _mixer;
+	}
+
+private:
+	uint _outputRate;
+};
+
+class OSystem_NULL_Mixer : public OSystem_NULL {
+public:
+	OSystem_NULL_Mixer(bool silenceLogs, uint outputRate) : OSystem_NULL(silenceLogs) {
+		_mixerManager = new TestMixerManager(outputRate);
+	}
+
+	Audio::MixerImpl *getMixerImpl() {
+		return ((TestMixerManager *)_mixerManager)->getMixerImpl();
+	}
+};
+
+static OSystem_NULL_Mixer *g_nullMixerSystem = nullptr;
+
+void Common::install_null_g_system_with_mixer(uint outputRate, bool silenceLogs) {
+#ifdef DISPLAY_ERROR_MESSAGES
+	silenceLogs = false;
+#endif
+
+	g_nullMixerSystem = new OSystem_NULL_Mixer(silenceLogs, outputRate);
+	g_system = g_nullMixerSystem;
+}
+
+Audio::MixerImpl *Common::get_null_mixer() {
+	assert(g_nullMixerSystem);
+	return g_nullMixerSystem->getMixerImpl();
+}
+
 bool BaseBackend::setScaler(const char *name, int factor) {
 	return false;
 }
@@ -1,8 +1,21 @@
 #ifndef TEST_NULL_OSYSTEM
 #define TEST_NULL_OSYSTEM 1
+namespace Audio {
+class MixerImpl;
+}
 namespace Common {
 #if defined(POSIX) || defined(WIN32)
-void install_null_g_system();
+void install_null_g_system(bool silenceLogs = true);
+/**
+ * Install the null system with a mixer running at @p outputRate. Nothing
+ * calls the mixer on its own; use get_null_mixer() to mix.
+ */
+void install_null_g_system_with_mixer(unsigned int outputRate, bool silenceLogs = true);
+/**
+ * Return the mixer of the system installed by install_null_g_system_with_mixer().
+ * It is created on the first call, so audio settings can be changed before.
+ */
+Audio::MixerImpl *get_null_mixer();
 #define NULL_OSYSTEM_IS_AVAILABLE 1
 #else
 #define NULL_OSYSTEM_IS_AVAILABLE 0
@@ -0,0 +1,177 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+namespace {
+
+/** A video whose frames and palette entries hold their frame number */
+class TestVideoDecoder : public Video::VideoDecoder {
+public:
+	TestVideoDecoder() : _track(nullptr), _packets(0) {}
+	~TestVideoDecoder() { close(); }
+
+	bool loadStream(Common::SeekableReadStream *stream) override { return false; }
+
+	void load(int frameCount, bool hasSideState = false) {
+		_track = new TestVideoTrack(frameCount, hasSideState);
+		addTrack(_track);
+	}
+
+	int getTrackFrame() const { return _track->getCurFrame(); }
+	int getPackets() const { return _packets; }
+
+protected:
+	void readNextPacket() override { _packets++; }
+
+private:
+	class TestVideoTrack : public FixedRateVideoTrack {
+	public:
+		TestVideoTrack(int frameCount, bool hasSideState) : _frameCount(frameCount), _curFrame(-1), _hasSideState(hasSideState), _dirtyPalette(false) {
+			_surface.create(4, 2, Graphics::PixelFormat::createFormatCLUT8());
+			memset(_palette, 0, sizeof(_palette));
+		}
+		~TestVideoTrack() { _surface.free(); }
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return _frameCount; }
+		bool isSeekable() const override { return true; }
+		bool supportsDecodeAhead() const override { return !_hasSideState; }
+		const byte *getPalette() const override { _dirtyPalette = false; return _palette; }
+		bool hasDirtyPalette() const override { return _dirtyPalette; }
+
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame++;
+			_surface.fillRect(Common::Rect(_surface.w, _surface.h), _curFrame);
+
+			// A new palette every fourth frame
+			if (_curFrame % 4 == 0) {
+				_palette[0] = _curFrame;
+				_dirtyPalette = true;
+			}
+			return &_surface;
+		}
+
+	protected:
+		Common::Rational getFrameRate() const override { return 10; }
+
+	private:
+		int _frameCount;
+		int _curFrame;
+		bool _hasSideState;
+		Graphics::Surface _surface;
+		byte _palette[256 * 3];
+		mutable bool _dirtyPalette;
+	};
+
+	TestVideoTrack *_track;
+	int _packets;
+};
+
+} // End of anonymous namespace
+
+class DecodeAheadTestSuite : public CxxTest::TestSuite {
+public:
+#if NULL_OSYSTEM_IS_AVAILABLE
+	void test_queue() {
+		Common::install_null_g_system();
+
+		TestVideoDecoder video;
+		TS_ASSERT(!video.setDecodeAhead(3));
+		video.load(20);
+		TS_ASSERT(video.setDecodeAhead(3));
+
+		// Nothing is decoded ahead before the first frame
+		TS_ASSERT(!video.decodeAhead());
+
+		const Graphics::Surface *last = nullptr;
+		for (int i = 0; i < 20; i++) {
+			const Graphics::Surface *frame = video.decodeNextFrame();
+			TS_ASSERT(frame);
+			TS_ASSERT_EQUALS(*(const byte *)frame->getBasePtr(3, 1), i);
+			TS_ASSERT_EQUALS(video.getCurFrame(), i);
+			// The timing follows the frame shown, not the decoding
+			TS_ASSERT_EQUALS(video.getTimeToNextFrame(), i < 19 ? (uint32)(i + 1) * 100 : 0u);
+
+			// Each packet is read once, for its own frame
+			TS_ASSERT_EQUALS(video.getPackets(), video.getTrackFrame() + 1);
+
+			TS_ASSERT_EQUALS(video.hasDirtyPalette(), i % 4 == 0);
+			if (i % 4 == 0)
+				TS_ASSERT_EQUALS(video.getPalette()[0], i);
+
+			// Fill the queue, without touching the frame in use
+			const int decodedBefore = video.getTrackFrame();
+			int decoded = 0;
+			for (int j = 0; j < 5; j++)
+				decoded += video.decodeAhead();
+			TS_ASSERT_EQUALS(decoded, MIN(i + 3, 19) - decodedBefore);
+			TS_ASSERT_EQUALS(video.getTrackFrame(), MIN(i + 3, 19));
+			TS_ASSERT_EQUALS(*(const byte *)frame->getPixels(), i);
+			TS_ASSERT_DIFFERS(frame, last);
+			last = frame;
+		}
+
+		TS_ASSERT(video.endOfVideo());
+		TS_ASSERT(!video.decodeNextFrame());
+	}
+
+	void test_seek() {
+		Common::install_null_g_system();
+
+		TestVideoDecoder video;
+		video.load(20);
+		TS_ASSERT(video.setDecodeAhead(4));
+
+		for (int i = 0; i < 3; i++)
+			video.decodeNextFrame();
+		TS_ASSERT(video.decodeAhead());
+		TS_ASSERT(video.decodeAhead());
+		TS_ASSERT_EQUALS(video.getTrackFrame(), 4);
+
+		// Can't be changed while playing
+		TS_ASSERT(!video.setDecodeAhead(2));
+
+		TS_ASSERT(video.seekToFrame(10));
+		TS_ASSERT_EQUALS(video.getCurFrame(), 9);
+		const Graphics::Surface *frame = video.decodeNextFrame();
+		TS_ASSERT_EQUALS(*(const byte *)frame->getPixels(), 10);
+		TS_ASSERT_EQUALS(video.getCurFrame(), 10);
+
+		// The palette of frame 4 was thrown away with the queue
+		TS_ASSERT_EQUALS(video.getPalette()[0], 0);
+
+		TS_ASSERT(video.rewind());
+		TS_ASSERT_EQUALS(video.getCurFrame(), -1);
+		TS_ASSERT(video.setDecodeAhead(0));
+		frame = video.decodeNextFrame();
+		TS_ASSERT_EQUALS(*(const byte *)frame->getPixels(), 0);
+		TS_ASSERT_EQUALS(video.getTrackFrame(), 0);
+	}
+
+	void test_side_state() {
+		Common::install_null_g_system();
+
+		// Per-frame state other than the surface and palette would belong
+		// to the wrong frame, so such tracks can't be queued
+		TestVideoDecoder video;
+		video.load(20, true);
+		TS_ASSERT(!video.setDecodeAhead(3));
+		TS_ASSERT(video.setDecodeAhead(0));
+
+		video.decodeNextFrame();
+		TS_ASSERT(!video.decodeAhead());
+		TS_ASSERT_EQUALS(video.getTrackFrame(), 0);
+	}
+#endif
+};
@@ -158,6 +158,7 @@ private:
 		int getFrameCount() const override { return _frameCount; }
 		const Graphics::Surface *decodeNextFrame() override { return _surface; }
 		bool isSeekable() const  override{ return true; }
+		bool supportsDecodeAhead() const override { return true; }
 		bool seek(const Audio::Timestamp &time) override { return true; }
 		bool rewind() override;
 		void setCurFrame(uint32 frame) { _curFrame = frame; }
@@ -26,10 +26,181 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/rect.h"
 #include "common/system.h"
 
+#include "graphics/surface.h"
+
 namespace Video {
 
+/**
+ * Stands in for the video track in _tracks while decoding ahead. The frames
+ * of the track are decoded into a queue, and the state reported is the one
+ * after the frame last taken from it, so that the timing does not depend on
+ * how far ahead the decoding is.
+ */
+class VideoDecoder::DecodeAheadVideoTrack : public VideoDecoder::VideoTrack {
+public:
+	DecodeAheadVideoTrack(VideoDecoder *decoder, VideoTrack *track, uint frames);
+	~DecodeAheadVideoTrack();
+
+	VideoTrack *getTrack() const { return _track; }
+
+	/**
+	 * Decode another frame if there is room in the queue.
+	 *
+	 * @return true if a frame was decoded
+	 */
+	bool decodeAhead();
+
+	/** Throw the queued frames away, after the track was repositioned. */
+	void flush();
+
+	bool endOfTrack() const override { return _endOfTrack; }
+	bool isRewindable() const override { return _track->isRewindable(); }
+	bool rewind() override { return _track->rewind(); }
+	bool isSeekable() const override { return _track->isSeekable(); }
+	bool seek(const Audio::Timestamp &time) override { return _track->seek(time); }
+	Audio::Timestamp getDuration() const override { return _track->getDuration(); }
+	uint16 getWidth() const override { return _track->getWidth(); }
+	uint16 getHeight() const override { return _track->getHeight(); }
+	Graphics::PixelFormat getPixelFormat() const override { return _track->getPixelFormat(); }
+	int getCurFrame() const override { return _curFrame; }
+	int getFrameCount() const override { return _track->getFrameCount(); }
+	uint32 getNextFrameStartTime() const override { return _nextFrameStartTime; }
+	const Graphics::Surface *decodeNextFrame() override;
+	const byte *getPalette() const override { _dirtyPalette = false; return _hasPalette ? _palette : nullptr; }
+	bool hasDirtyPalette() const override { return _dirtyPalette; }
+	Audio::Timestamp getFrameTime(uint frame) const override { return _track->getFrameTime(frame); }
+	bool isReversed() const override { return _track->isReversed(); }
+
+protected:
+	void pauseIntern(bool shouldPause) override { _track->pause(shouldPause); }
+
+private:
+	/** A decoded frame, and the state of the track after decoding it. */
+	struct Frame {
+		Graphics::Surface surface;
+		bool hasSurface; ///< The track returned a surface for this frame
+		int curFrame;
+		uint32 nextFrameStartTime;
+		bool endOfTrack;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+	};
+
+	void decodeFrame();
+	void syncState();
+
+	VideoDecoder *_decoder;
+	VideoTrack *_track;
+
+	/**
+	 * The queue of decoded frames, plus one for the frame which was returned
+	 * last and may still be in use.
+	 */
+	Frame *_frames;
+	uint _queueSize;
+	uint32 _decoded;   ///< Number of frames put in the queue
+	uint32 _presented; ///< Number of frames taken from the queue
+
+	int _curFrame;
+	uint32 _nextFrameStartTime;
+	bool _endOfTrack;
+	mutable bool _dirtyPalette;
+	bool _hasPalette;
+	byte _palette[256 * 3];
+};
+
+VideoDecoder::DecodeAheadVideoTrack::DecodeAheadVideoTrack(VideoDecoder *decoder, VideoTrack *track, uint frames) :
+		_decoder(decoder), _track(track), _queueSize(frames + 1), _decoded(0), _presented(0),
+		_dirtyPalette(false), _hasPalette(false) {
+	_frames = new Frame[_queueSize];
+	for (uint i = 0; i < _queueSize; i++) {
+		_frames[i].hasSurface = false;
+		_frames[i].dirtyPalette = false;
+	}
+
+	if (track->isPaused())
+		pause(true);
+
+	syncState();
+}
+
+VideoDecoder::DecodeAheadVideoTrack::~DecodeAheadVideoTrack() {
+	for (uint i = 0; i < _queueSize; i++)
+		_frames[i].surface.free();
+
+	delete[] _frames;
+}
+
+void VideoDecoder::DecodeAheadVideoTrack::syncState() {
+	_curFrame = _track->getCurFrame();
+	_nextFrameStartTime = _track->getNextFrameStartTime();
+	_endOfTrack = _track->endOfTrack();
+}
+
+void VideoDecoder::DecodeAheadVideoTrack::flush() {
+	// Keep the frame returned last, it may still be on screen
+	_decoded = _presented;
+	syncState();
+}
+
+bool VideoDecoder::DecodeAheadVideoTrack::decodeAhead() {
+	if (_decoded - _presented >= _queueSize - 1 || _track->endOfTrack())
+		return false;
+
+	decodeFrame();
+	return true;
+}
+
+void VideoDecoder::DecodeAheadVideoTrack::decodeFrame() {
+	Frame &frame = _frames[_decoded % _queueSize];
+
+	_decoder->readNextPacket();
+	const Graphics::Surface *surface = _track->decodeNextFrame();
+
+	// The track reuses its surface, so keep a copy
+	frame.hasSurface = surface != nullptr;
+	if (surface) {
+		if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != surface->format) {
+			frame.surface.free();
+			frame.surface.create(surface->w, surface->h, surface->format);
+		}
+		frame.surface.copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+	}
+
+	frame.curFrame = _track->getCurFrame();
+	frame.nextFrameStartTime = _track->getNextFrameStartTime();
+	frame.endOfTrack = _track->endOfTrack();
+
+	frame.dirtyPalette = _track->hasDirtyPalette();
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, _track->getPalette(), sizeof(frame.palette));
+
+	_decoded++;
+}
+
+const Graphics::Surface *VideoDecoder::DecodeAheadVideoTrack::decodeNextFrame() {
+	// Decode it here if it was not decoded ahead
+	if (_decoded == _presented)
+		decodeFrame();
+
+	const Frame &frame = _frames[_presented++ % _queueSize];
+
+	_curFrame = frame.curFrame;
+	_nextFrameStartTime = frame.nextFrameStartTime;
+	_endOfTrack = frame.endOfTrack;
+
+	if (frame.dirtyPalette) {
+		memcpy(_palette, frame.palette, sizeof(_palette));
+		_hasPalette = true;
+		_dirtyPalette = true;
+	}
+
+	return frame.hasSurface ? &frame.surface : nullptr;
+}
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -47,12 +218,16 @@ VideoDecoder::VideoDecoder() {
 	_mainAudioTrack = 0;
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
+	_decodeAheadFrames = 0;
+	_decodeAheadTrack = nullptr;
 }
 
 void VideoDecoder::close() {
 	if (isPlaying())
 		stop();
 
+	destroyDecodeAheadTrack();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		delete *it;
 
@@ -73,6 +248,7 @@ void VideoDecoder::close() {
 	_mainAudioTrack = 0;
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
+	_decodeAheadFrames = 0;
 }
 
 bool VideoDecoder::loadFile(const Common::Path &filename) {
@@ -204,7 +380,16 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
-	readNextPacket();
+	if (_decodeAheadFrames && !_decodeAheadTrack)
+		wrapDecodeAheadTrack();
+
+	if (!_decodeAheadTrack) {
+		readNextPacket();
+	} else if (_decodeAheadTrack->endOfTrack()) {
+		// The video track only reads ahead up to its last frame, keep
+		// reading packets for the audio tracks
+		readNextPacket();
+	}
 
 	// If we have no next video track at this point, there shouldn't be
 	// any frame available for us to display.
@@ -224,6 +409,78 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	return frame;
 }
 
+bool VideoDecoder::setDecodeAhead(uint frames) {
+	// Without a frame shown, the track state is the same with and without
+	// the queue
+	if (getCurFrame() >= 0)
+		return false;
+
+	if (frames) {
+		uint videoTracks = 0;
+		for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+			if ((*it)->getTrackType() != Track::kTrackTypeVideo)
+				continue;
+
+			if (!((const VideoTrack *)*it)->supportsDecodeAhead())
+				return false;
+			videoTracks++;
+		}
+
+		if (videoTracks != 1)
+			return false;
+	}
+
+	destroyDecodeAheadTrack();
+	_decodeAheadFrames = frames;
+	return true;
+}
+
+void VideoDecoder::wrapDecodeAheadTrack() {
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() != Track::kTrackTypeVideo)
+			continue;
+
+		VideoTrack *track = (VideoTrack *)*it;
+		if (track->isReversed())
+			return;
+
+		_decodeAheadTrack = new DecodeAheadVideoTrack(this, track, _decodeAheadFrames);
+		*it = _decodeAheadTrack;
+		if (_nextVideoTrack == track)
+			_nextVideoTrack = _decodeAheadTrack;
+		return;
+	}
+}
+
+void VideoDecoder::destroyDecodeAheadTrack() {
+	if (!_decodeAheadTrack)
+		return;
+
+	VideoTrack *track = _decodeAheadTrack->getTrack();
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
+		if (*it == _decodeAheadTrack)
+			*it = track;
+
+	if (_nextVideoTrack == _decodeAheadTrack)
+		_nextVideoTrack = track;
+	if (_palette && _palette == _decodeAheadTrack->getPalette())
+		_palette = track->getPalette();
+
+	delete _decodeAheadTrack;
+	_decodeAheadTrack = nullptr;
+}
+
+void VideoDecoder::resetDecodeAhead() {
+	if (_decodeAheadTrack)
+		_decodeAheadTrack->flush();
+}
+
+bool VideoDecoder::decodeAhead() {
+	// The queue is only set up by the first decodeNextFrame() call, so
+	// that the output format can't change any more
+	return _decodeAheadTrack && _decodeAheadTrack->decodeAhead();
+}
+
 bool VideoDecoder::setReverse(bool reverse) {
 	// Can only reverse video-only videos
 	if (reverse && hasAudio())
@@ -347,6 +604,8 @@ bool VideoDecoder::rewind() {
 		if (!(*it)->rewind())
 			return false;
 
+	resetDecodeAhead();
+
 	// Now that we've rewound, start all tracks again
 	if (isPlaying())
 		startAudio();
@@ -378,7 +637,10 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 		stopAudio();
 
 	// Do the actual seeking
-	if (!seekIntern(time))
+	bool result = seekIntern(time);
+	resetDecodeAhead();
+
+	if (!result)
 		return false;
 
 	// Seek any external track too
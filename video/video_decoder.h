@@ -395,6 +395,36 @@ public:
 	 */
 	bool setOutputPixelFormat(const Graphics::PixelFormat &format);
 
+	/**
+	 * Allow up to the given number of frames to be decoded ahead of the one
+	 * returned by decodeNextFrame(), see decodeAhead(). decodeNextFrame()
+	 * then usually only takes an already decoded frame from a queue, which
+	 * evens out the time it takes. The decoded frames are copied into a pool
+	 * of surfaces which are reused; their palettes are kept with them.
+	 * Seeking and rewinding throw the queued frames away.
+	 *
+	 * This should be called after loadStream(), and can only be changed
+	 * before the first decodeNextFrame() call, or after a rewind. It is only
+	 * supported for videos with a single video track, which is played
+	 * forward and supports it, see VideoTrack::supportsDecodeAhead().
+	 *
+	 * @param frames The number of frames to decode ahead, 0 to decode each
+	 *               frame when it is requested
+	 * @return true on success, false otherwise
+	 */
+	bool setDecodeAhead(uint frames);
+
+	/**
+	 * Decode one frame ahead, if setDecodeAhead() was used and the queue is
+	 * not full yet. Call this while waiting for the next frame to be due,
+	 * to make use of that time. Frames not decoded ahead are decoded by
+	 * decodeNextFrame() itself, so the result does not depend on how often
+	 * this is called.
+	 *
+	 * @return true if a frame was decoded
+	 */
+	bool decodeAhead();
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -645,6 +675,15 @@ protected:
 		 */
 		virtual bool isReversed() const { return false; }
 
+		/**
+		 * Can the frames of the video track be decoded before they are
+		 * shown? This requires the surface, the palette and the timing to
+		 * be all that changes with a frame. Tracks with more state per
+		 * frame, e.g. dirty rectangles, must not allow it, as that state
+		 * would belong to the last frame decoded instead of the one shown.
+		 */
+		virtual bool supportsDecodeAhead() const { return false; }
+
 		/**
 		 * Can the video track dither?
 		 */
@@ -959,6 +998,23 @@ protected:
 	virtual AudioTrack *getAudioTrack(int index) { return 0; }
 
 private:
+	class DecodeAheadVideoTrack;
+
+	/**
+	 * Put a DecodeAheadVideoTrack in place of the video track, if decoding
+	 * ahead was requested.
+	 */
+	void wrapDecodeAheadTrack();
+
+	/** Throw the queued frames away, after the tracks were repositioned. */
+	void resetDecodeAhead();
+
+	/** Put the video track back in place. */
+	void destroyDecodeAheadTrack();
+
+	uint _decodeAheadFrames;
+	DecodeAheadVideoTrack *_decodeAheadTrack;
+
 	// Tracks owned by this VideoDecoder
 	TrackList _tracks;
 	TrackList _internalTracks;